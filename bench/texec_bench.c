@@ -0,0 +1,521 @@
+#include "texec/texec.h"
+#include "texec/version.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+// texec_bench: runs every scenario against every executor kind and backpressure policy and
+// prints one JSON document to stdout, so results can be diffed between releases.
+//
+// Usage: texec_bench [--quick] [--max-threads N] [--scenario NAME]
+
+#define BENCH_QUEUE_CAPACITY 1024
+#define BENCH_MAX_PRODUCERS 64
+
+typedef struct bench_options {
+  size_t tasks;           // tasks per throughput / contention run
+  size_t latency_samples;
+  size_t fanout_width;    // tasks per submit_many round
+  size_t fanout_rounds;
+  size_t max_threads;     // contention scales producers and workers 1, 2, 4, ... up to this
+  const char* scenario;   // NULL runs all
+} bench_options_t;
+
+static const texec_executor_kind_t BENCH_KINDS[] = {
+  TEXEC_EXECUTOR_KIND_INLINE,
+  TEXEC_EXECUTOR_KIND_THREAD_POOL,
+  TEXEC_EXECUTOR_KIND_WORK_STEALING,
+};
+
+static const texec_backpressure_policy_t BENCH_POLICIES[] = {
+  TEXEC_BACKPRESSURE_REJECT,
+  TEXEC_BACKPRESSURE_BLOCK,
+  TEXEC_BACKPRESSURE_CALLER_RUNS,
+};
+
+#define BENCH_COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+static bool bench_first_result = true;
+
+static const char* bench_kind_name(texec_executor_kind_t kind) {
+  switch (kind) {
+  case TEXEC_EXECUTOR_KIND_INLINE: return "inline";
+  case TEXEC_EXECUTOR_KIND_THREAD_POOL: return "thread_pool";
+  case TEXEC_EXECUTOR_KIND_WORK_STEALING: return "work_stealing";
+  default: return "unknown";
+  }
+}
+
+static const char* bench_policy_name(texec_backpressure_policy_t bp) {
+  switch (bp) {
+  case TEXEC_BACKPRESSURE_REJECT: return "reject";
+  case TEXEC_BACKPRESSURE_BLOCK: return "block";
+  case TEXEC_BACKPRESSURE_CALLER_RUNS: return "caller_runs";
+  default: return "unknown";
+  }
+}
+
+static void bench_fail(const char* what, texec_status_t st) {
+  fprintf(stderr, "texec_bench: %s failed: %d\n", what, (int)st);
+  exit(1);
+}
+
+static double bench_seconds(uint64_t start_ns, uint64_t end_ns) {
+  return (double)(end_ns - start_ns) / 1e9;
+}
+
+// --- JSON output ---
+
+static void bench_begin_result(const char* scenario) {
+  printf("%s\n    {\"scenario\": \"%s\"", bench_first_result ? "" : ",", scenario);
+  bench_first_result = false;
+}
+
+static void bench_field_str(const char* name, const char* value) {
+  printf(", \"%s\": \"%s\"", name, value);
+}
+
+static void bench_field_u64(const char* name, uint64_t value) {
+  printf(", \"%s\": %llu", name, (unsigned long long)value);
+}
+
+static void bench_field_f64(const char* name, double value) {
+  printf(", \"%s\": %.6f", name, value);
+}
+
+static void bench_end_result(void) {
+  printf("}");
+}
+
+static void bench_executor_fields(texec_executor_kind_t kind, texec_backpressure_policy_t bp, size_t workers) {
+  bench_field_str("executor", bench_kind_name(kind));
+  bench_field_str("backpressure", bench_policy_name(bp));
+  bench_field_u64("workers", kind == TEXEC_EXECUTOR_KIND_INLINE ? 0 : workers);
+}
+
+// --- Helpers ---
+
+static texec_executor_t* bench_create_executor(texec_executor_kind_t kind, texec_backpressure_policy_t bp, size_t workers) {
+  const texec_executor_create_pool_info_t pool = {
+    .header = {.type = TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_POOL_INFO, .next = NULL},
+    .slab_capacity = 0,
+    .thread_cache_capacity = 0,
+  };
+  const texec_executor_create_thread_pool_info_t tpci = {
+    .header = {.type = TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_THREAD_POOL_INFO, .next = &pool},
+    .thread_count = workers,
+    .queue_capacity = BENCH_QUEUE_CAPACITY,
+    .backpressure = bp,
+  };
+  const texec_executor_create_info_t eci = {
+    .header = {.type = TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_INFO, .next = &tpci},
+    .kind = kind,
+  };
+
+  texec_executor_t* ex = NULL;
+  texec_status_t st = texec_executor_create(&eci, NULL, &ex);
+  if (st != TEXEC_STATUS_OK) bench_fail("texec_executor_create", st);
+  return ex;
+}
+
+static void bench_destroy_executor(texec_executor_t* ex) {
+  texec_executor_close(ex);
+  texec_executor_join(ex);
+  texec_status_t st = texec_executor_destroy(ex);
+  if (st != TEXEC_STATUS_OK) bench_fail("texec_executor_destroy", st);
+}
+
+static texec_task_group_t* bench_create_group(void) {
+  const texec_task_group_create_info_t gci = {
+    .header = {.type = TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_INFO, .next = NULL},
+    .capacity = 0,
+  };
+  texec_task_group_t* g = NULL;
+  texec_status_t st = texec_task_group_create(&gci, NULL, &g);
+  if (st != TEXEC_STATUS_OK) bench_fail("texec_task_group_create", st);
+  return g;
+}
+
+// Submits, retrying while a REJECT executor is full. Returns the number of retries.
+static uint64_t bench_submit(texec_executor_t* ex, const texec_submit_info_t* si, texec_task_handle_t** out_handle) {
+  uint64_t retries = 0;
+  for (;;) {
+    texec_status_t st = texec_executor_submit(ex, si, out_handle);
+    if (st == TEXEC_STATUS_OK) return retries;
+    if (st != TEXEC_STATUS_REJECTED) bench_fail("texec_executor_submit", st);
+    ++retries;
+    thrd_yield();
+  }
+}
+
+static int bench_empty_task(void* ctx) {
+  (void)ctx;
+  return 0;
+}
+
+static int bench_compare_u64(const void* a, const void* b) {
+  const uint64_t x = *(const uint64_t*)a;
+  const uint64_t y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+static void bench_percentiles_field(const char* name, uint64_t* samples, size_t count) {
+  qsort(samples, count, sizeof(uint64_t), bench_compare_u64);
+  printf(", \"%s\": {\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"max\": %llu}",
+         name,
+         (unsigned long long)samples[count * 50 / 100],
+         (unsigned long long)samples[count * 90 / 100],
+         (unsigned long long)samples[count * 99 / 100],
+         (unsigned long long)samples[count - 1]);
+}
+
+// --- Scenarios ---
+
+// Detached empty tasks from one producer, counted by a group.
+static void bench_submit_throughput(const bench_options_t* opt, texec_executor_kind_t kind, texec_backpressure_policy_t bp) {
+  const size_t workers = opt->max_threads;
+  texec_executor_t* ex = bench_create_executor(kind, bp, workers);
+  texec_task_group_t* g = bench_create_group();
+
+  const texec_submit_group_info_t sgi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_SUBMIT_GROUP, .next = NULL},
+    .group = g,
+  };
+  const texec_submit_info_t si = {
+    .header = {.type = TEXEC_STRUCT_TYPE_SUBMIT_INFO, .next = &sgi},
+    .task = {.run = bench_empty_task, .ctx = NULL},
+  };
+
+  uint64_t retries = 0;
+  const uint64_t start = texec_clock_now_ns();
+  for (size_t i = 0; i < opt->tasks; ++i) {
+    retries += bench_submit(ex, &si, NULL);
+  }
+  texec_task_group_wait(g);
+  const uint64_t end = texec_clock_now_ns();
+
+  texec_task_group_destroy(g);
+  bench_destroy_executor(ex);
+
+  bench_begin_result("submit_throughput");
+  bench_executor_fields(kind, bp, workers);
+  bench_field_u64("tasks", opt->tasks);
+  bench_field_f64("seconds", bench_seconds(start, end));
+  bench_field_f64("tasks_per_sec", (double)opt->tasks / bench_seconds(start, end));
+  bench_field_u64("rejected_retries", retries);
+  bench_end_result();
+}
+
+typedef struct bench_latency_ctx {
+  uint64_t started_ns;
+} bench_latency_ctx_t;
+
+static int bench_latency_task(void* ctx) {
+  ((bench_latency_ctx_t*)ctx)->started_ns = texec_clock_now_ns();
+  return 0;
+}
+
+// One task in flight at a time: time until it starts running and until its result is observed.
+static void bench_latency(const bench_options_t* opt, texec_executor_kind_t kind, texec_backpressure_policy_t bp) {
+  const size_t workers = opt->max_threads;
+  texec_executor_t* ex = bench_create_executor(kind, bp, workers);
+
+  uint64_t* to_start = malloc(opt->latency_samples * sizeof(uint64_t));
+  uint64_t* to_result = malloc(opt->latency_samples * sizeof(uint64_t));
+  if (!to_start || !to_result) bench_fail("malloc", TEXEC_STATUS_OUT_OF_MEMORY);
+
+  bench_latency_ctx_t ctx = {0};
+  const texec_submit_info_t si = {
+    .header = {.type = TEXEC_STRUCT_TYPE_SUBMIT_INFO, .next = NULL},
+    .task = {.run = bench_latency_task, .ctx = &ctx},
+  };
+
+  for (size_t i = 0; i < opt->latency_samples; ++i) {
+    texec_task_handle_t* h = NULL;
+    const uint64_t submitted = texec_clock_now_ns();
+    bench_submit(ex, &si, &h);
+    texec_task_handle_wait(h);
+    const uint64_t done = texec_clock_now_ns();
+    texec_task_handle_release(h);
+
+    to_start[i] = ctx.started_ns - submitted;
+    to_result[i] = done - submitted;
+  }
+
+  bench_destroy_executor(ex);
+
+  bench_begin_result("latency");
+  bench_executor_fields(kind, bp, workers);
+  bench_field_u64("samples", opt->latency_samples);
+  bench_percentiles_field("submit_to_start_ns", to_start, opt->latency_samples);
+  bench_percentiles_field("submit_to_result_ns", to_result, opt->latency_samples);
+  bench_end_result();
+
+  free(to_start);
+  free(to_result);
+}
+
+// submit_many of `fanout_width` tasks, then a single wait on the returned group.
+static void bench_fanout(const bench_options_t* opt, texec_executor_kind_t kind, texec_backpressure_policy_t bp) {
+  const size_t workers = opt->max_threads;
+  texec_executor_t* ex = bench_create_executor(kind, bp, workers);
+
+  texec_submit_info_t* infos = malloc(opt->fanout_width * sizeof(texec_submit_info_t));
+  if (!infos) bench_fail("malloc", TEXEC_STATUS_OUT_OF_MEMORY);
+  for (size_t i = 0; i < opt->fanout_width; ++i) {
+    infos[i] = (texec_submit_info_t){
+      .header = {.type = TEXEC_STRUCT_TYPE_SUBMIT_INFO, .next = NULL},
+      .task = {.run = bench_empty_task, .ctx = NULL},
+    };
+  }
+
+  uint64_t rejected_rounds = 0;
+  const uint64_t start = texec_clock_now_ns();
+  for (size_t r = 0; r < opt->fanout_rounds; ++r) {
+    texec_task_group_t* g = NULL;
+    texec_status_t st = texec_executor_submit_many(ex, infos, opt->fanout_width, &g);
+    if (st == TEXEC_STATUS_REJECTED) {
+      ++rejected_rounds;
+      continue;
+    }
+    if (st != TEXEC_STATUS_OK) bench_fail("texec_executor_submit_many", st);
+    texec_task_group_wait(g);
+    texec_task_group_destroy(g);
+  }
+  const uint64_t end = texec_clock_now_ns();
+
+  bench_destroy_executor(ex);
+  free(infos);
+
+  const double seconds = bench_seconds(start, end);
+  bench_begin_result("fanout");
+  bench_executor_fields(kind, bp, workers);
+  bench_field_u64("width", opt->fanout_width);
+  bench_field_u64("rounds", opt->fanout_rounds);
+  bench_field_f64("seconds", seconds);
+  bench_field_f64("rounds_per_sec", (double)opt->fanout_rounds / seconds);
+  bench_field_u64("rejected_rounds", rejected_rounds);
+  bench_end_result();
+}
+
+typedef struct bench_producer {
+  texec_executor_t* ex;
+  texec_task_group_t* group;
+  size_t tasks;
+  uint64_t retries;
+} bench_producer_t;
+
+static int bench_producer_main(void* arg) {
+  bench_producer_t* p = (bench_producer_t*)arg;
+
+  const texec_submit_group_info_t sgi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_SUBMIT_GROUP, .next = NULL},
+    .group = p->group,
+  };
+  const texec_submit_info_t si = {
+    .header = {.type = TEXEC_STRUCT_TYPE_SUBMIT_INFO, .next = &sgi},
+    .task = {.run = bench_empty_task, .ctx = NULL},
+  };
+
+  for (size_t i = 0; i < p->tasks; ++i) {
+    p->retries += bench_submit(p->ex, &si, NULL);
+  }
+  return 0;
+}
+
+// `threads` producers submitting into an executor with `threads` workers.
+static void bench_contention_run(const bench_options_t* opt, texec_executor_kind_t kind, texec_backpressure_policy_t bp, size_t threads) {
+  texec_executor_t* ex = bench_create_executor(kind, bp, threads);
+  texec_task_group_t* g = bench_create_group();
+
+  bench_producer_t producers[BENCH_MAX_PRODUCERS];
+  thrd_t handles[BENCH_MAX_PRODUCERS];
+  const size_t per_producer = opt->tasks / threads;
+
+  const uint64_t start = texec_clock_now_ns();
+  for (size_t i = 0; i < threads; ++i) {
+    producers[i] = (bench_producer_t){.ex = ex, .group = g, .tasks = per_producer, .retries = 0};
+    if (thrd_create(&handles[i], bench_producer_main, &producers[i]) != thrd_success) {
+      bench_fail("thrd_create", TEXEC_STATUS_INTERNAL_ERROR);
+    }
+  }
+
+  uint64_t retries = 0;
+  for (size_t i = 0; i < threads; ++i) {
+    thrd_join(handles[i], NULL);
+    retries += producers[i].retries;
+  }
+  texec_task_group_wait(g);
+  const uint64_t end = texec_clock_now_ns();
+
+  texec_task_group_destroy(g);
+  bench_destroy_executor(ex);
+
+  const size_t tasks = per_producer * threads;
+  bench_begin_result("contention");
+  bench_executor_fields(kind, bp, threads);
+  bench_field_u64("producers", threads);
+  bench_field_u64("tasks", tasks);
+  bench_field_f64("seconds", bench_seconds(start, end));
+  bench_field_f64("tasks_per_sec", (double)tasks / bench_seconds(start, end));
+  bench_field_u64("rejected_retries", retries);
+  bench_end_result();
+}
+
+static void bench_contention(const bench_options_t* opt, texec_executor_kind_t kind, texec_backpressure_policy_t bp) {
+  for (size_t threads = 1; threads <= opt->max_threads; threads *= 2) {
+    bench_contention_run(opt, kind, bp, threads);
+  }
+}
+
+typedef struct bench_queue_worker {
+  texec_queue_t* q;
+  size_t items;
+} bench_queue_worker_t;
+
+static int bench_queue_producer_main(void* arg) {
+  bench_queue_worker_t* w = (bench_queue_worker_t*)arg;
+  for (size_t i = 0; i < w->items; ++i) {
+    texec_status_t st = texec_queue_push(w->q, (uintptr_t)(i + 1));
+    if (st != TEXEC_STATUS_OK) bench_fail("texec_queue_push", st);
+  }
+  return 0;
+}
+
+static int bench_queue_consumer_main(void* arg) {
+  bench_queue_worker_t* w = (bench_queue_worker_t*)arg;
+  for (size_t i = 0; i < w->items; ++i) {
+    uintptr_t item = 0;
+    texec_status_t st = texec_queue_pop(w->q, &item);
+    if (st != TEXEC_STATUS_OK) bench_fail("texec_queue_pop", st);
+  }
+  return 0;
+}
+
+// Raw blocking push/pop with `threads` producers and as many consumers.
+static void bench_queue_run(const bench_options_t* opt, texec_queue_mode_t mode, size_t threads) {
+  const texec_queue_create_mode_info_t qmi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_QUEUE_CREATE_MODE_INFO, .next = NULL},
+    .mode = mode,
+  };
+  const texec_queue_create_info_t qi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_QUEUE_CREATE_INFO, .next = &qmi},
+    .capacity = BENCH_QUEUE_CAPACITY,
+  };
+  texec_queue_t* q = NULL;
+  texec_status_t st = texec_queue_create(&qi, NULL, &q);
+  if (st != TEXEC_STATUS_OK) bench_fail("texec_queue_create", st);
+
+  bench_queue_worker_t worker = {.q = q, .items = opt->tasks / threads};
+  thrd_t producers[BENCH_MAX_PRODUCERS];
+  thrd_t consumers[BENCH_MAX_PRODUCERS];
+
+  const uint64_t start = texec_clock_now_ns();
+  for (size_t i = 0; i < threads; ++i) {
+    if (thrd_create(&consumers[i], bench_queue_consumer_main, &worker) != thrd_success ||
+        thrd_create(&producers[i], bench_queue_producer_main, &worker) != thrd_success) {
+      bench_fail("thrd_create", TEXEC_STATUS_INTERNAL_ERROR);
+    }
+  }
+  for (size_t i = 0; i < threads; ++i) {
+    thrd_join(producers[i], NULL);
+    thrd_join(consumers[i], NULL);
+  }
+  const uint64_t end = texec_clock_now_ns();
+
+  texec_queue_close(q);
+  st = texec_queue_destroy(q);
+  if (st != TEXEC_STATUS_OK) bench_fail("texec_queue_destroy", st);
+
+  const size_t items = worker.items * threads;
+  bench_begin_result("queue");
+  bench_field_str("mode", mode == TEXEC_QUEUE_MODE_LOCK_FREE ? "lock_free" : "locked");
+  bench_field_u64("producers", threads);
+  bench_field_u64("consumers", threads);
+  bench_field_u64("items", items);
+  bench_field_f64("seconds", bench_seconds(start, end));
+  bench_field_f64("items_per_sec", (double)items / bench_seconds(start, end));
+  bench_end_result();
+}
+
+typedef void (*bench_executor_scenario_fn_t)(const bench_options_t* opt, texec_executor_kind_t kind, texec_backpressure_policy_t bp);
+
+typedef struct bench_scenario {
+  const char* name;
+  bench_executor_scenario_fn_t run;
+} bench_scenario_t;
+
+static const bench_scenario_t BENCH_EXECUTOR_SCENARIOS[] = {
+  {"submit_throughput", bench_submit_throughput},
+  {"latency", bench_latency},
+  {"fanout", bench_fanout},
+  {"contention", bench_contention},
+};
+
+static bool bench_selected(const bench_options_t* opt, const char* name) {
+  return !opt->scenario || strcmp(opt->scenario, name) == 0;
+}
+
+static bool bench_parse_args(int argc, char** argv, bench_options_t* opt) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--quick") == 0) {
+      opt->tasks /= 10;
+      opt->latency_samples /= 10;
+      opt->fanout_rounds /= 10;
+    } else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+      const long n = strtol(argv[++i], NULL, 10);
+      if (n < 1 || n > BENCH_MAX_PRODUCERS) return false;
+      opt->max_threads = (size_t)n;
+    } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+      opt->scenario = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  bench_options_t opt = {
+    .tasks = 200000,
+    .latency_samples = 20000,
+    .fanout_width = 256,
+    .fanout_rounds = 2000,
+    .max_threads = 4,
+    .scenario = NULL,
+  };
+
+  if (!bench_parse_args(argc, argv, &opt)) {
+    fprintf(stderr, "usage: %s [--quick] [--max-threads N] [--scenario NAME]\n", argv[0]);
+    return 2;
+  }
+
+  printf("{\n  \"texec_version\": \"%d.%d.%d\",\n  \"max_threads\": %zu,\n  \"results\": [",
+         TEXEC_VERSION_MAJOR, TEXEC_VERSION_MINOR, TEXEC_VERSION_PATCH, opt.max_threads);
+
+  for (size_t s = 0; s < BENCH_COUNT_OF(BENCH_EXECUTOR_SCENARIOS); ++s) {
+    if (!bench_selected(&opt, BENCH_EXECUTOR_SCENARIOS[s].name)) continue;
+
+    for (size_t k = 0; k < BENCH_COUNT_OF(BENCH_KINDS); ++k) {
+      for (size_t p = 0; p < BENCH_COUNT_OF(BENCH_POLICIES); ++p) {
+        BENCH_EXECUTOR_SCENARIOS[s].run(&opt, BENCH_KINDS[k], BENCH_POLICIES[p]);
+        fflush(stdout);
+      }
+    }
+  }
+
+  if (bench_selected(&opt, "queue")) {
+    for (size_t threads = 1; threads <= opt.max_threads; threads *= 2) {
+      bench_queue_run(&opt, TEXEC_QUEUE_MODE_LOCKED, threads);
+      bench_queue_run(&opt, TEXEC_QUEUE_MODE_LOCK_FREE, threads);
+      fflush(stdout);
+    }
+  }
+
+  printf("\n  ]\n}\n");
+  return 0;
+}
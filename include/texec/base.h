@@ -15,7 +15,9 @@ typedef enum texec_status {
   TEXEC_STATUS_UNSUPPORTED,
   TEXEC_STATUS_INVALID_ARGUMENT,
   TEXEC_STATUS_OUT_OF_MEMORY,
-  TEXEC_STATUS_INTERNAL_ERROR
+  TEXEC_STATUS_INTERNAL_ERROR,
+  TEXEC_STATUS_EXPIRED, // task was dropped because its deadline passed before it could run
+  TEXEC_STATUS_CANCELLED // task was dropped because its cancel token was cancelled before it could run
 } texec_status_t;
 
 typedef enum texec_struct_type {
@@ -23,17 +25,34 @@ typedef enum texec_struct_type {
   TEXEC_STRUCT_TYPE_SUBMIT_INFO                      = 0x2000,
   TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_INFO           = 0x3000,
   TEXEC_STRUCT_TYPE_QUEUE_CREATE_INFO                = 0x4000,
+  TEXEC_STRUCT_TYPE_SCHEDULE_INFO                    = 0x5000,
+  TEXEC_STRUCT_TYPE_SUBMIT_INTRUSIVE_INFO            = 0x6000,
   
   TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_INLINE_INFO      = 0x1001,
   TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_THREAD_POOL_INFO = 0x1002,
   TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_DIAGNOSTICS_INFO = 0x1003,
+  TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_POOL_INFO        = 0x1004,
+  TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_DEADLINE_INFO    = 0x1005,
+  TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_ELASTIC_INFO     = 0x1006,
+  TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_AFFINITY_INFO    = 0x1007,
+  TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_IDLE_INFO        = 0x1008,
   
   TEXEC_STRUCT_TYPE_SUBMIT_PRIORITY                  = 0x2001,
   TEXEC_STRUCT_TYPE_SUBMIT_DEADLINE                  = 0x2002,
   TEXEC_STRUCT_TYPE_SUBMIT_TRACE_CONTEXT             = 0x2003,
   TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE              = 0x2004,
+  TEXEC_STRUCT_TYPE_SUBMIT_GROUP                     = 0x2005,
+  TEXEC_STRUCT_TYPE_SUBMIT_NODE                      = 0x2006,
+  TEXEC_STRUCT_TYPE_SUBMIT_DEPENDENCIES              = 0x2007,
+  TEXEC_STRUCT_TYPE_SUBMIT_CANCEL                    = 0x2008,
+  TEXEC_STRUCT_TYPE_SUBMIT_RESULT_PAYLOAD            = 0x2009,
+  TEXEC_STRUCT_TYPE_SUBMIT_CONTEXT                   = 0x200A,
+
+  TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_AGGREGATE_INFO = 0x3001,
+  TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_CANCEL_INFO    = 0x3002,
   
   TEXEC_STRUCT_TYPE_QUEUE_CREATE_FULL_POLICY_INFO    = 0x4001,
+  TEXEC_STRUCT_TYPE_QUEUE_CREATE_MODE_INFO           = 0x4002,
 } texec_struct_type_t;
 
 typedef enum texec_backpressure_policy {
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "texec/base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A flag shared by every task it is attached to (see texec_submit_cancel_info_t). Once cancelled,
+// attached tasks that have not started are dropped with TEXEC_STATUS_CANCELLED instead of run;
+// running tasks are not interrupted but may poll texec_cancel_token_is_cancelled and return early.
+typedef struct texec_cancel_token texec_cancel_token_t;
+
+texec_status_t texec_cancel_token_create(const texec_allocator_t* allocator, texec_cancel_token_t** out_token);
+
+// Tasks and groups the token is attached to hold their own reference.
+texec_status_t texec_cancel_token_retain(texec_cancel_token_t* token);
+void texec_cancel_token_release(texec_cancel_token_t* token);
+
+// Idempotent and irreversible.
+void texec_cancel_token_cancel(texec_cancel_token_t* token);
+bool texec_cancel_token_is_cancelled(const texec_cancel_token_t* token);
+
+#ifdef __cplusplus
+}
+#endif
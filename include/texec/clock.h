@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Monotonic time in nanoseconds from an unspecified origin; the clock deadlines are expressed in.
+uint64_t texec_clock_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "texec/base.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -10,12 +12,14 @@ struct texec_task;
 typedef void (*texec_on_submit_fn_t)(void* user, const struct texec_submit_info_t* submit_info);
 typedef void (*texec_on_task_begin_fn_t)(void* user, const struct texec_task* task, const void* trace_context);
 typedef void (*texec_on_task_end_fn_t)(void* user, const struct texec_task* task, const void* trace_context, int task_result);
+typedef void (*texec_on_task_dropped_fn_t)(void* user, const struct texec_task* task, const void* trace_context, texec_status_t reason);
 
 typedef struct texec_diagnostics {
   void* user;
   texec_on_submit_fn_t on_submit;
   texec_on_task_begin_fn_t on_task_begin;
   texec_on_task_end_fn_t on_task_end;
+  texec_on_task_dropped_fn_t on_task_dropped; // optional; task completed without running (e.g. TEXEC_STATUS_EXPIRED)
 } texec_diagnostics_t;
 
 #ifdef __cplusplus
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "texec/base.h"
 #include "texec/executor_create_info.h"
 #include "texec/executor_submit_info.h"
 #include "texec/task_handle.h"
 #include "texec/task_group.h"
+#include "texec/timer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,18 +18,51 @@ typedef struct texec_executor texec_executor_t;
 
 texec_status_t texec_executor_create(const texec_executor_create_info_t* info, const texec_allocator_t* allocator, texec_executor_t** out_executor);
 texec_status_t texec_executor_destroy(texec_executor_t* ex);
-texec_status_t texec_executor_submit(texec_executor_t* ex, const texec_submit_info_t* info, texec_task_handle_t** out_handle);
+texec_status_t texec_executor_submit(texec_executor_t* ex, const texec_submit_info_t* info, texec_task_handle_t** out_handle); // out_handle may be NULL (detached)
+// Submits a caller-owned task without allocating; see texec_submit_intrusive_info_t.
+texec_status_t texec_executor_submit_intrusive(texec_executor_t* ex, const texec_submit_intrusive_info_t* info);
 texec_status_t texec_executor_submit_many(texec_executor_t* ex, const texec_submit_info_t* infos, size_t count, texec_task_group_t** out_group);
+// out_timer may be NULL when the timer is never cancelled. Timers run on a thread the executor
+// starts on first use, which hands due runs to the executor like any other submit.
+texec_status_t texec_executor_schedule(texec_executor_t* ex, const texec_schedule_info_t* info, texec_timer_t** out_timer);
 void texec_executor_close(texec_executor_t* ex);
 void texec_executor_join(texec_executor_t* ex);
 
 typedef enum texec_executor_capability {
-  TEXEC_EXECUTOR_CAPABILITY_WORKER_COUNT = 1,  // out: size_t
+  TEXEC_EXECUTOR_CAPABILITY_WORKER_COUNT = 1,  // out: size_t; the maximum for elastic pools
   TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_PRIORITY, // out: bool
   TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_DEADLINE, // out: bool
-  TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_TRACING   // out: bool
+  TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_TRACING,  // out: bool
+  TEXEC_EXECUTOR_CAPABILITY_EXPIRED_COUNT,     // out: uint64_t; tasks dropped with TEXEC_STATUS_EXPIRED
+  TEXEC_EXECUTOR_CAPABILITY_METRICS,           // out: texec_executor_metrics_t
+  TEXEC_EXECUTOR_CAPABILITY_WORKER_METRICS,    // out: texec_worker_metrics_t[WORKER_COUNT]
+  TEXEC_EXECUTOR_CAPABILITY_LIVE_WORKER_COUNT, // out: size_t; worker threads currently running
+  TEXEC_EXECUTOR_CAPABILITY_IDLE_WORKER_COUNT, // out: size_t; live workers parked waiting for work
+  TEXEC_EXECUTOR_CAPABILITY_NODE_COUNT         // out: size_t; NUMA nodes with their own run queues (1 without numa_queues)
 } texec_executor_capability_t;
 
+// Metrics are snapshots of counters the workers keep for themselves; values of different
+// fields (and of different workers) are not read atomically with respect to each other.
+typedef struct texec_worker_metrics {
+  uint64_t tasks_executed;
+  uint64_t steals;      // tasks taken from another worker's deque (work-stealing pool only)
+  uint64_t parks;       // times the worker found no work and went to sleep
+  uint64_t busy_ns;     // time awake, running or looking for tasks
+  uint64_t idle_ns;     // time parked
+  size_t queue_depth;   // tasks in the worker's own deque; 0 on the thread pool (shared queues only)
+} texec_worker_metrics_t;
+
+typedef struct texec_executor_metrics {
+  uint64_t tasks_executed;   // by workers; tasks run on a submitting thread count as caller_runs
+  uint64_t steals;
+  uint64_t parks;
+  uint64_t busy_ns;
+  uint64_t idle_ns;
+  size_t queue_depth;        // tasks queued anywhere in the executor
+  uint64_t rejected_submits; // submits that returned TEXEC_STATUS_REJECTED because the executor was full
+  uint64_t caller_runs;      // tasks run by the submitter under TEXEC_BACKPRESSURE_CALLER_RUNS
+} texec_executor_metrics_t;
+
 texec_status_t texec_executor_query(const texec_executor_t* ex, texec_executor_capability_t cap, void* out_value);
 
 #ifdef __cplusplus
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "texec/base.h"
 #include "texec/diagnostics.h"
@@ -10,8 +12,9 @@ extern "C" {
 #endif
 
 typedef enum texec_executor_kind {
-  TEXEC_EXECUTOR_KIND_INLINE = 1,
-  TEXEC_EXECUTOR_KIND_THREAD_POOL
+  TEXEC_EXECUTOR_KIND_INLINE = 1, // runs tasks on the submitting thread; needs no create extension
+  TEXEC_EXECUTOR_KIND_THREAD_POOL,
+  TEXEC_EXECUTOR_KIND_WORK_STEALING // configured with texec_executor_create_thread_pool_info_t
 } texec_executor_kind_t;
 
 typedef struct texec_executor_create_info {
@@ -33,6 +36,70 @@ typedef struct texec_executor_create_diagnostics_info {
   const texec_diagnostics_t* diag;
 } texec_executor_create_diagnostics_info_t;
 
+// Enables pooled work items and task handles, carved from slabs of the executor's allocator.
+// Pooled memory is returned to the allocator once the executor is destroyed and every
+// outstanding handle has been released (or, for objects cached by a thread that is still
+// running, when that thread exits).
+typedef struct texec_executor_create_pool_info {
+  texec_structure_header_t header;
+  size_t slab_capacity;         // objects per slab allocation; 0 selects a default
+  size_t thread_cache_capacity; // free objects cached per thread; 0 selects a default
+} texec_executor_create_pool_info_t;
+
+typedef enum texec_deadline_policy {
+  TEXEC_DEADLINE_POLICY_RUN_LATE = 0, // expired tasks still run
+  TEXEC_DEADLINE_POLICY_DROP_EXPIRED  // expired tasks complete with TEXEC_STATUS_EXPIRED without running
+} texec_deadline_policy_t;
+
+// What the executor does with tasks whose texec_submit_deadline_info_t deadline has passed by the
+// time they would run. On the thread pool, tasks with a deadline always run earliest-deadline-first;
+// the inline executor checks the deadline at submit.
+typedef struct texec_executor_create_deadline_info {
+  texec_structure_header_t header;
+  texec_deadline_policy_t policy;
+} texec_executor_create_deadline_info_t;
+
+// Lets the thread pool grow from `min_threads` to `max_threads` workers under load. A worker is
+// added on submit when no worker is idle and either `grow_queue_depth` tasks are queued or queued
+// work has not been picked up for `grow_sojourn_ns`. Workers above `min_threads` retire after
+// `idle_timeout_ns` without work. The thread pool info's `thread_count` is ignored.
+typedef struct texec_executor_create_elastic_info {
+  texec_structure_header_t header;
+  size_t min_threads;       // >= 1
+  size_t max_threads;       // >= min_threads
+  uint64_t idle_timeout_ns; // 0 selects a default (1 s)
+  size_t grow_queue_depth;  // 0 selects 1: grow as soon as work queues up with every worker busy
+  uint64_t grow_sojourn_ns; // 0 disables the sojourn trigger
+} texec_executor_create_elastic_info_t;
+
+typedef enum texec_worker_pinning {
+  TEXEC_WORKER_PINNING_NONE = 0, // workers float over all of the pool's CPUs
+  TEXEC_WORKER_PINNING_NODE,     // each worker floats over the CPUs of one NUMA node
+  TEXEC_WORKER_PINNING_CPU       // each worker is pinned to a single CPU
+} texec_worker_pinning_t;
+
+// Places pool workers on CPUs. The pool uses the listed `cpus`, or every CPU the creating thread
+// may run on if `cpus` is NULL; workers are spread round-robin over NUMA nodes. Placement is
+// best effort: platforms without affinity support (anything but Linux and Windows) ignore it.
+typedef struct texec_executor_create_affinity_info {
+  texec_structure_header_t header;
+  const unsigned int* cpus; // optional
+  size_t cpu_count;
+  texec_worker_pinning_t pinning;
+  bool size_to_cpus; // size the pool (or cap an elastic pool) to the usable CPUs, further capped by the cgroup CPU quota
+  bool numa_queues;  // thread pool: one set of run queues per NUMA node, allocated on that node
+} texec_executor_create_affinity_info_t;
+
+// How thread pool workers wait for work. A worker that runs out of tasks polls the run queues
+// `spin_count` times with a CPU pause in between, then `yield_count` times giving up its time
+// slice, and only then parks. Spinning burns CPU while idle but lets sparse tasks start without
+// a wake-up; by default workers park right away.
+typedef struct texec_executor_create_idle_info {
+  texec_structure_header_t header;
+  uint32_t spin_count;
+  uint32_t yield_count;
+} texec_executor_create_idle_info_t;
+
 #ifdef __cplusplus
 }
 #endif
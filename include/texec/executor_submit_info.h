@@ -3,7 +3,10 @@
 #include <stdint.h>
 
 #include "texec/base.h"
+#include "texec/cancel_token.h"
 #include "texec/task.h"
+#include "texec/task_group.h"
+#include "texec/task_handle.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,6 +17,30 @@ typedef struct texec_submit_info {
   texec_task_t task;
 } texec_submit_info_t;
 
+// A task embedded in storage the caller owns, such as a field of a long-lived object. Submitted
+// with texec_executor_submit_intrusive, it is queued as is: the executor allocates nothing for it.
+typedef struct texec_intrusive_task texec_intrusive_task_t;
+
+// Takes the place of a handle: `status` is TEXEC_STATUS_OK with the task's result if it ran, or
+// the reason it was dropped with a result of 0.
+typedef void (*texec_intrusive_task_done_fn_t)(texec_intrusive_task_t* t, texec_status_t status, int result);
+
+struct texec_intrusive_task {
+  texec_task_t task; // task.on_complete, if set, is called as for any task
+  // Optional; called last, after task.on_complete. The executor no longer touches `t` once it
+  // is called, so `t` may be submitted again or freed from there.
+  texec_intrusive_task_done_fn_t done;
+};
+
+// Chain priority, deadline, backpressure or NUMA node info to apply them. Extensions that need
+// storage of their own (group, cancel, dependencies, trace context, result payload, context
+// copy) are ignored. From a successful submit until `done` is called, the task belongs to the
+// executor and must not be modified or submitted again; a failed submit leaves it untouched.
+typedef struct texec_submit_intrusive_info {
+  texec_structure_header_t header;
+  texec_intrusive_task_t* task;
+} texec_submit_intrusive_info_t;
+
 // --- Submit Extensions ---
 
 typedef enum texec_submit_priority {
@@ -27,6 +54,7 @@ typedef struct texec_submit_priority_info {
   texec_submit_priority_t priority;
 } texec_submit_priority_info_t;
 
+// `deadline_ns` is absolute, on the texec_clock_now_ns() clock
 typedef struct texec_submit_deadline_info {
   texec_structure_header_t header;
   uint64_t deadline_ns;
@@ -42,6 +70,69 @@ typedef struct texec_submit_backpressure_info {
   texec_backpressure_policy_t backpressure;
 } texec_submit_backpressure_info_t;
 
+// Counts the task in `group`; completion decrements the group's pending counter.
+// Combine with a NULL out_handle to skip the per-task handle entirely.
+typedef struct texec_submit_group_info {
+  texec_structure_header_t header;
+  texec_task_group_t* group;
+} texec_submit_group_info_t;
+
+// Queues the task on NUMA node `node` (an OS node number) of a thread pool created with
+// `numa_queues`, so it runs on a worker of that node unless the others run out of work.
+// Other executors ignore it; a node the pool has no CPUs on is TEXEC_STATUS_INVALID_ARGUMENT.
+// Without it, tasks go to the node of the submitting CPU.
+typedef struct texec_submit_node_info {
+  texec_structure_header_t header;
+  unsigned int node;
+} texec_submit_node_info_t;
+
+// Holds the task back until every handle in `handles` has completed, whether it ran or was
+// dropped, then submits it with the rest of its chain; nothing blocks in the meantime. Submit
+// returns at once, and the task's handle (if requested) and group count it from then on.
+// Predecessors may belong to any executor; `ex` must not be destroyed while successors are
+// pending. Released successors never block: a full queue runs them on the completing thread
+// unless backpressure info asks for TEXEC_BACKPRESSURE_REJECT. A successor that cannot be
+// submitted when released (e.g. TEXEC_STATUS_CLOSED) is dropped with that status.
+// Only honoured by texec_executor_submit; submit_many rejects it.
+typedef struct texec_submit_dependencies_info {
+  texec_structure_header_t header;
+  texec_task_handle_t* const* handles;
+  size_t count;
+} texec_submit_dependencies_info_t;
+
+// Drops the task with TEXEC_STATUS_CANCELLED, without running it, if `token` is cancelled before
+// a worker starts it. The executor holds a reference to the token until the task is done. Overrides
+// the cancel token of the task's group, if it has one.
+typedef struct texec_submit_cancel_info {
+  texec_structure_header_t header;
+  texec_cancel_token_t* token;
+} texec_submit_cancel_info_t;
+
+// Largest result payload a submit can reserve.
+#define TEXEC_SUBMIT_RESULT_PAYLOAD_MAX 64
+
+// Reserves `size` bytes (at most TEXEC_SUBMIT_RESULT_PAYLOAD_MAX, zero-filled) in the task's
+// handle, allocated with it, for a result that does not fit the int returned by run. The task
+// writes it through texec_task_result_payload and the caller reads it with
+// texec_task_handle_payload. Ignored when no handle is requested, and by submit_many.
+typedef struct texec_submit_result_payload_info {
+  texec_structure_header_t header;
+  size_t size;
+} texec_submit_result_payload_info_t;
+
+// Context blobs up to this size are copied into the queued task itself.
+#define TEXEC_SUBMIT_CONTEXT_INLINE_MAX 48
+
+// Runs the task with a copy of the `size` bytes at `data` as its ctx, in place of task.ctx, so the
+// caller's blob only has to live until submit returns. Blobs up to TEXEC_SUBMIT_CONTEXT_INLINE_MAX
+// bytes are stored in the queued task, larger ones come from the executor's allocator. The copy is
+// aligned for any type and stays valid until on_complete returns; `size` 0 passes a NULL ctx.
+typedef struct texec_submit_context_info {
+  texec_structure_header_t header;
+  const void* data;
+  size_t size;
+} texec_submit_context_info_t;
+
 #ifdef __cplusplus
 }
 #endif
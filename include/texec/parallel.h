@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "texec/base.h"
+#include "texec/executor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Processes the index range [begin, end) on the executor and the calling thread together. The
+// range is split lazily: a chunk hands off half of what it has left only while no other handed
+// off chunk is waiting to be picked up, so the number of tasks follows the number of threads that
+// are actually free rather than the number of elements. `grain` is the most indices a single call
+// of the body covers; 0 picks one from the range size and worker count.
+// Both calls return once every index has been processed. If the executor cannot take more work
+// (full or closed), the caller processes the rest itself.
+
+typedef void (*texec_parallel_for_fn_t)(void* ctx, size_t begin, size_t end);
+
+texec_status_t texec_parallel_for(texec_executor_t* ex, size_t begin, size_t end, size_t grain, texec_parallel_for_fn_t fn, void* ctx);
+
+typedef struct texec_parallel_reducer {
+  size_t value_size;
+  size_t value_align; // power of two; 0 for the alignment of max_align_t
+  const void* identity; // value every partial result starts from
+  // Folds the indices [begin, end) into `acc`.
+  void (*fold)(void* ctx, size_t begin, size_t end, void* acc);
+  // Merges `other`, which covers the indices right after those of `acc`, into `acc`. Partial
+  // results are combined in index order, so the operation only needs to be associative.
+  void (*combine)(void* ctx, void* acc, const void* other);
+} texec_parallel_reducer_t;
+
+// Writes the reduction of [begin, end) to `out_value` (value_size bytes).
+texec_status_t texec_parallel_reduce(texec_executor_t* ex,
+                                     size_t begin,
+                                     size_t end,
+                                     size_t grain,
+                                     const texec_parallel_reducer_t* reducer,
+                                     void* ctx,
+                                     void* out_value);
+
+#ifdef __cplusplus
+}
+#endif
@@ -15,12 +15,30 @@ texec_status_t texec_queue_create(const texec_queue_create_info_t* info, const t
 texec_status_t texec_queue_destroy(texec_queue_t* q);
 void texec_queue_close(texec_queue_t* q);
 
+// Number of queued items; may already be stale when it returns.
+size_t texec_queue_size(texec_queue_t* q);
+
 texec_status_t texec_queue_try_push(texec_queue_t* q, uintptr_t item);
 texec_status_t texec_queue_try_pop(texec_queue_t* q, uintptr_t* out_item);
 
 texec_status_t texec_queue_push(texec_queue_t* q, uintptr_t item);
 texec_status_t texec_queue_pop(texec_queue_t* q, uintptr_t* out_item);
 
+// Bulk variants move several items per lock acquisition (or per CAS in lock-free mode) and wake
+// at most as many waiters as there are items.
+//
+// try_push_many pushes what fits and returns TEXEC_STATUS_REJECTED if not all of `items` did;
+// push_many blocks until all are pushed. Both return TEXEC_STATUS_CLOSED if the queue was closed
+// part-way. `out_pushed` may be NULL; otherwise it receives the number of leading items pushed.
+texec_status_t texec_queue_try_push_many(texec_queue_t* q, const uintptr_t* items, size_t count, size_t* out_pushed);
+texec_status_t texec_queue_push_many(texec_queue_t* q, const uintptr_t* items, size_t count, size_t* out_pushed);
+
+// Pops between 1 and `max_count` items in FIFO order. try_pop_many returns TEXEC_STATUS_REJECTED
+// when the queue is empty; pop_many blocks until at least one item is available. Both return
+// TEXEC_STATUS_CLOSED once the queue is closed and drained.
+texec_status_t texec_queue_try_pop_many(texec_queue_t* q, uintptr_t* out_items, size_t max_count, size_t* out_popped);
+texec_status_t texec_queue_pop_many(texec_queue_t* q, uintptr_t* out_items, size_t max_count, size_t* out_popped);
+
 static inline texec_status_t texec_queue_try_push_ptr(texec_queue_t* q, void* p) {
   return texec_queue_try_push(q, (uintptr_t)p);
 }
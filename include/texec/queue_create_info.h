@@ -16,6 +16,16 @@ typedef struct texec_queue_create_info {
 
 // --- Queue Create Extensions ---
 
+typedef enum texec_queue_mode {
+  TEXEC_QUEUE_MODE_LOCKED = 0, // mutex + condition variables
+  TEXEC_QUEUE_MODE_LOCK_FREE   // lock-free ring, capacity rounded up to a power of two
+} texec_queue_mode_t;
+
+typedef struct texec_queue_create_mode_info {
+  texec_structure_header_t header;
+  texec_queue_mode_t mode;
+} texec_queue_create_mode_info_t;
+
 #ifdef __cplusplus
 }
 #endif
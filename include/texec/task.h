@@ -10,7 +10,7 @@ typedef void (*texec_task_on_complete_fn_t)(void* ctx);
 typedef struct texec_task {
   texec_task_run_t run;
   void* ctx;
-  texec_task_on_complete_fn_t on_complete; // optional; called after run, on the executing thread
+  texec_task_on_complete_fn_t on_complete; // optional; called after run (or when the task is dropped), on the executing thread
 } texec_task_t;
 
 #ifdef __cplusplus
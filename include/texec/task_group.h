@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "texec/base.h"
 #include "texec/task_handle.h"
@@ -15,10 +16,24 @@ typedef struct texec_task_group texec_task_group_t;
 texec_status_t texec_task_group_create(const texec_task_group_create_info_t* info, const texec_allocator_t* allocator, texec_task_group_t** out_group);
 void texec_task_group_destroy(texec_task_group_t* g);
 
+// A group tracks tasks two ways: handles added with texec_task_group_add, and tasks submitted
+// with a texec_submit_group_info_t, which only bump a pending counter and need no handle.
+// Destroying a group with counted tasks still pending is allowed; it is freed once they finish.
+
 texec_status_t texec_task_group_add(texec_task_group_t* g, texec_task_handle_t* h); // retains handle internally
 
+// Waits for every added handle and for the pending counter to drain. Closes the group to further
+// texec_task_group_add calls; counted tasks may still be submitted into it, also from its own tasks.
 texec_status_t texec_task_group_wait(texec_task_group_t* g);
 
+// Like texec_task_group_wait, but gives up with TEXEC_STATUS_NOT_READY once `timeout_ns` has
+// passed (TEXEC_WAIT_FOREVER for no limit). Handles not done yet stay in the group for a later wait.
+texec_status_t texec_task_group_wait_for(texec_task_group_t* g, uint64_t timeout_ns);
+
+// Waits like texec_task_group_wait, then reports the aggregated result.
+// Returns TEXEC_STATUS_UNSUPPORTED if the group was created without aggregation.
+texec_status_t texec_task_group_result(texec_task_group_t* g, long long* out_result);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,6 +3,7 @@
 #include <stddef.h>
 
 #include "texec/base.h"
+#include "texec/cancel_token.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,6 +16,26 @@ typedef struct texec_task_group_create_info {
 
 // --- Task Group Create Extensions ---
 
+typedef enum texec_task_group_aggregate {
+  TEXEC_TASK_GROUP_AGGREGATE_NONE = 0,
+  TEXEC_TASK_GROUP_AGGREGATE_FIRST_ERROR, // first non-zero result to complete, 0 if none
+  TEXEC_TASK_GROUP_AGGREGATE_SUM
+} texec_task_group_aggregate_t;
+
+// Folds the results of the group's tasks into one value, read with texec_task_group_result
+typedef struct texec_task_group_create_aggregate_info {
+  texec_structure_header_t header;
+  texec_task_group_aggregate_t aggregate;
+} texec_task_group_create_aggregate_info_t;
+
+// Attaches `token` to every task counted by the group (submitted with texec_submit_group_info_t)
+// that does not carry its own texec_submit_cancel_info_t, so cancelling it drops the whole group's
+// queued work. The group holds a reference to the token.
+typedef struct texec_task_group_create_cancel_info {
+  texec_structure_header_t header;
+  texec_cancel_token_t* token;
+} texec_task_group_create_cancel_info_t;
+
 #ifdef __cplusplus
 }
 #endif
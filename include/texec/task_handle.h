@@ -1,6 +1,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "texec/base.h"
 
 #ifdef __cplusplus
@@ -9,18 +11,49 @@ extern "C" {
 
 typedef struct texec_task_handle texec_task_handle_t;
 
+// Timeout of the timed waits below that never expires.
+#define TEXEC_WAIT_FOREVER UINT64_MAX
+
 texec_status_t texec_task_handle_retain(texec_task_handle_t* h);
 void texec_task_handle_release(texec_task_handle_t* h);
 
+// Both return the drop reason (e.g. TEXEC_STATUS_EXPIRED) instead of TEXEC_STATUS_OK if the task
+// completed without running; *out_result is 0 then.
 texec_status_t texec_task_handle_try_result(texec_task_handle_t* h, int* out_result);
 texec_status_t texec_task_handle_result(texec_task_handle_t* h, int* out_result);
 bool texec_task_handle_is_done(texec_task_handle_t* h);
 
+// Like texec_task_handle_result, but gives up with TEXEC_STATUS_NOT_READY once `timeout_ns` has
+// passed.
+texec_status_t texec_task_handle_result_for(texec_task_handle_t* h, uint64_t timeout_ns, int* out_result);
+
 static inline texec_status_t texec_task_handle_wait(texec_task_handle_t* h) {
   int result;
   return texec_task_handle_result(h, &result);
 }
 
+static inline texec_status_t texec_task_handle_wait_for(texec_task_handle_t* h, uint64_t timeout_ns) {
+  int result;
+  return texec_task_handle_result_for(h, timeout_ns, &result);
+}
+
+// Result storage reserved with a texec_submit_result_payload_info_t, readable once the handle is
+// done: returns the status texec_task_handle_try_result would. *out_payload is NULL and *out_size
+// 0 if none was reserved; a task that was dropped leaves it zero-filled.
+texec_status_t texec_task_handle_payload(texec_task_handle_t* h, const void** out_payload, size_t* out_size);
+
+// Result storage of the task running on the calling thread, to be written before it returns. NULL
+// if the task was submitted without one, or without a handle. `out_size` may be NULL.
+void* texec_task_result_payload(size_t* out_size);
+
+// Wait for the first of `handles` to be done, or for all of them, for at most `timeout_ns`
+// (TEXEC_WAIT_FOREVER for no limit). Both return TEXEC_STATUS_NOT_READY on timeout; wait_any
+// stores the index of a done handle, the lowest if several are, in *out_index. Read results with
+// texec_task_handle_try_result. The caller parks once on a notification shared by all handles,
+// and each completing task wakes it in O(1), however many handles are watched.
+texec_status_t texec_task_handle_wait_any(texec_task_handle_t* const* handles, size_t count, uint64_t timeout_ns, size_t* out_index);
+texec_status_t texec_task_handle_wait_all(texec_task_handle_t* const* handles, size_t count, uint64_t timeout_ns);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,15 +3,19 @@
 #include "texec/version.h"
 
 #include "texec/base.h"
+#include "texec/clock.h"
+#include "texec/cancel_token.h"
 
 #include "texec/task.h"
 #include "texec/task_handle.h"
 #include "texec/task_group_create_info.h"
 #include "texec/task_group.h"
+#include "texec/timer.h"
 
 #include "texec/executor_create_info.h"
 #include "texec/executor_submit_info.h"
 #include "texec/executor.h"
+#include "texec/parallel.h"
 
 #include "texec/queue_create_info.h"
 #include "texec/queue.h"
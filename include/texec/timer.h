@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "texec/base.h"
+#include "texec/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct texec_timer texec_timer_t;
+
+// Submits `task` to the executor once `delay_ns` has passed, then every `period_ns` if it is not
+// zero. Runs never overlap: the next period is counted from the previous due time, and periods
+// missed while a run was late or still going are skipped. `task.on_complete` is called once, when
+// the timer finishes: after its only run, or once it is cancelled or the executor is closed.
+// Chain priority, trace context, node or cancel info to apply it to every run; once a chained
+// cancel token is cancelled, the next run is dropped and the timer finishes with it.
+// A chained texec_submit_context_info_t is copied once, and every run gets the same copy.
+typedef struct texec_schedule_info {
+  texec_structure_header_t header;
+  texec_task_t task;
+  uint64_t delay_ns;
+  uint64_t period_ns;
+} texec_schedule_info_t;
+
+// Prevents further runs. Returns TEXEC_STATUS_OK if the timer was waiting for its next run,
+// TEXEC_STATUS_BUSY if a run is queued or in progress (it still completes, and the timer
+// finishes after it), or TEXEC_STATUS_CLOSED if the timer had already finished.
+texec_status_t texec_timer_cancel(texec_timer_t* t);
+void texec_timer_release(texec_timer_t* t);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,59 @@
+#include "texec/cancel_token.h"
+
+#include <stdatomic.h>
+
+#include "internal/allocator.h"
+
+struct texec_cancel_token {
+  atomic_bool cancelled;
+  atomic_uint refcount;
+  const texec_allocator_t* alloc;
+};
+
+texec_status_t texec_cancel_token_create(const texec_allocator_t* alloc, texec_cancel_token_t** out_token) {
+  if (!out_token) return TEXEC_STATUS_INVALID_ARGUMENT;
+  *out_token = NULL;
+
+  if (!alloc) {
+    alloc = texec_get_default_allocator();
+  }
+
+  texec_cancel_token_t* token = texec_allocate(alloc, sizeof(*token), _Alignof(texec_cancel_token_t));
+  if (!token) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  atomic_init(&token->cancelled, false);
+  atomic_init(&token->refcount, 1u);
+  token->alloc = alloc;
+  *out_token = token;
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_cancel_token_retain(texec_cancel_token_t* token) {
+  if (!token) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  unsigned int count = atomic_load_explicit(&token->refcount, memory_order_relaxed);
+  do {
+    if (count == 0u) return TEXEC_STATUS_INVALID_ARGUMENT; // use-after-free bug in caller
+  } while (!atomic_compare_exchange_weak_explicit(&token->refcount, &count, count + 1u, memory_order_relaxed, memory_order_relaxed));
+
+  return TEXEC_STATUS_OK;
+}
+
+void texec_cancel_token_release(texec_cancel_token_t* token) {
+  if (!token) return;
+
+  if (atomic_fetch_sub_explicit(&token->refcount, 1u, memory_order_release) == 1u) {
+    atomic_thread_fence(memory_order_acquire);
+    texec_free(token->alloc, token, sizeof(*token), _Alignof(texec_cancel_token_t));
+  }
+}
+
+void texec_cancel_token_cancel(texec_cancel_token_t* token) {
+  if (!token) return;
+  atomic_store_explicit(&token->cancelled, true, memory_order_release);
+}
+
+bool texec_cancel_token_is_cancelled(const texec_cancel_token_t* token) {
+  if (!token) return false;
+  return atomic_load_explicit((atomic_bool*)&token->cancelled, memory_order_acquire);
+}
@@ -0,0 +1,71 @@
+#include "internal/deadline_heap.h"
+
+#include "internal/allocator.h"
+
+static inline bool heap_entry_before(const texec_deadline_heap_entry_t* a, const texec_deadline_heap_entry_t* b) {
+  if (a->deadline_ns != b->deadline_ns) return a->deadline_ns < b->deadline_ns;
+  return a->seq < b->seq;
+}
+
+static inline void heap_swap(texec_deadline_heap_entry_t* a, texec_deadline_heap_entry_t* b) {
+  const texec_deadline_heap_entry_t tmp = *a;
+  *a = *b;
+  *b = tmp;
+}
+
+texec_status_t texec_deadline_heap_init(texec_deadline_heap_t* h, size_t capacity, const texec_allocator_t* alloc) {
+  texec_deadline_heap_entry_t* entries = texec_allocate(alloc, capacity * sizeof(*entries), _Alignof(texec_deadline_heap_entry_t));
+  if (!entries) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  h->entries = entries;
+  h->count = 0;
+  h->capacity = capacity;
+  h->next_seq = 0;
+  h->alloc = alloc;
+  return TEXEC_STATUS_OK;
+}
+
+void texec_deadline_heap_destroy(texec_deadline_heap_t* h) {
+  if (!h->entries) return;
+  texec_free(h->alloc, h->entries, h->capacity * sizeof(*h->entries), _Alignof(texec_deadline_heap_entry_t));
+  h->entries = NULL;
+}
+
+bool texec_deadline_heap_push(texec_deadline_heap_t* h, uint64_t deadline_ns, uintptr_t item) {
+  if (texec_deadline_heap_is_full(h)) return false;
+
+  size_t i = h->count++;
+  h->entries[i] = (texec_deadline_heap_entry_t){.deadline_ns = deadline_ns, .seq = h->next_seq++, .item = item};
+
+  while (i > 0) {
+    const size_t parent = (i - 1) / 2;
+    if (!heap_entry_before(&h->entries[i], &h->entries[parent])) break;
+    heap_swap(&h->entries[i], &h->entries[parent]);
+    i = parent;
+  }
+  return true;
+}
+
+bool texec_deadline_heap_pop(texec_deadline_heap_t* h, uint64_t* out_deadline_ns, uintptr_t* out_item) {
+  if (h->count == 0) return false;
+
+  *out_deadline_ns = h->entries[0].deadline_ns;
+  *out_item = h->entries[0].item;
+
+  h->entries[0] = h->entries[--h->count];
+
+  size_t i = 0;
+  for (;;) {
+    const size_t left = 2 * i + 1;
+    const size_t right = left + 1;
+    size_t smallest = i;
+
+    if (left < h->count && heap_entry_before(&h->entries[left], &h->entries[smallest])) smallest = left;
+    if (right < h->count && heap_entry_before(&h->entries[right], &h->entries[smallest])) smallest = right;
+    if (smallest == i) break;
+
+    heap_swap(&h->entries[i], &h->entries[smallest]);
+    i = smallest;
+  }
+  return true;
+}
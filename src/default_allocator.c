@@ -1,18 +1,42 @@
 #include "texec/base.h"
 #include "internal/allocator.h"
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdlib.h>
 
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+static inline bool is_over_aligned(size_t align) {
+  return align > _Alignof(max_align_t);
+}
+
 static void* standard_allocate(void* user, size_t size, size_t align) {
   (void)user;
-  (void)align;
-  return malloc(size);
+  if (!is_over_aligned(align)) {
+    return malloc(size);
+  }
+#if defined(_MSC_VER)
+  return _aligned_malloc(size, align);
+#else
+  // aligned_alloc requires the size to be a multiple of the alignment
+  return aligned_alloc(align, (size + align - 1) / align * align);
+#endif
 }
 
 static void standard_free(void* user, void* ptr, size_t size, size_t align) {
   (void)user;
   (void)size;
+#if defined(_MSC_VER)
+  if (is_over_aligned(align)) {
+    _aligned_free(ptr);
+    return;
+  }
+#else
   (void)align;
+#endif
   free(ptr);
 }
 
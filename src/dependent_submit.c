@@ -0,0 +1,238 @@
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "internal/allocator.h"
+#include "internal/executor.h"
+#include "internal/task_group.h"
+#include "internal/task_handle.h"
+
+// A submission waiting for its predecessors. The submit info and its known extensions are copied
+// because the caller's chain does not outlive texec_executor_submit; `pending` counts the
+// predecessors not yet done plus one for the registering thread, and whoever takes it to zero
+// submits the task and frees the record.
+
+typedef struct dependent_submit dependent_submit_t;
+
+typedef struct dependent_link {
+  texec_task_handle_continuation_t continuation; // first member: fire() casts back
+  dependent_submit_t* owner;
+} dependent_link_t;
+
+struct dependent_submit {
+  texec_executor_t* ex;
+  texec_task_t task;
+  atomic_size_t pending;
+  texec_task_handle_t* handle; // our reference to the successor's handle; NULL when detached
+  texec_task_group_t* group;   // counted once more until the task is submitted
+
+  bool has_priority;
+  bool has_deadline;
+  bool has_trace_context;
+  bool has_backpressure;
+  bool has_node;
+  bool has_cancel;
+  bool has_context;
+  texec_submit_priority_info_t priority;
+  texec_submit_deadline_info_t deadline;
+  texec_submit_trace_context_info_t trace_context;
+  texec_submit_backpressure_info_t backpressure;
+  texec_submit_node_info_t node;
+  texec_submit_cancel_info_t cancel; // holds a reference to the token
+  texec_submit_context_info_t context; // points at context_copy
+  texec_context_copy_t context_copy;
+
+  size_t link_count;
+  dependent_link_t links[];
+};
+
+static inline size_t dependent_size(size_t link_count) {
+  return sizeof(dependent_submit_t) + link_count * sizeof(dependent_link_t);
+}
+
+static void dependent_free(dependent_submit_t* d) {
+  if (d->has_context) texec_context_copy_release(&d->context_copy, d->ex->alloc);
+  texec_free(d->ex->alloc, d, dependent_size(d->link_count), _Alignof(dependent_submit_t));
+}
+
+// Copies extension `type` from the caller's chain into `dst` and reports whether it was there.
+static bool dependent_copy_extension(const texec_submit_info_t* info, texec_struct_type_t type, void* dst, size_t size) {
+  const void* src = texec_structure_find(info->header.next, type);
+  if (!src) return false;
+  memcpy(dst, src, size);
+  return true;
+}
+
+// Submits the task through the backend. `from_completion` is set when a predecessor's completer
+// releases it: that thread is usually a worker and must not block on a full queue.
+static texec_status_t dependent_submit_now(dependent_submit_t* d, bool from_completion) {
+  texec_executor_t* ex = d->ex;
+  const void* chain = NULL;
+
+  texec_submit_internal_handle_info_t handle_info;
+  if (d->handle) {
+    handle_info = (texec_submit_internal_handle_info_t){{TEXEC_STRUCT_TYPE_SUBMIT_INTERNAL_HANDLE, chain}, d->handle};
+    chain = &handle_info;
+  }
+
+  texec_submit_group_info_t group_info;
+  if (d->group) {
+    group_info = (texec_submit_group_info_t){{TEXEC_STRUCT_TYPE_SUBMIT_GROUP, chain}, d->group};
+    chain = &group_info;
+  }
+
+  if (from_completion && !(d->has_backpressure && d->backpressure.backpressure == TEXEC_BACKPRESSURE_REJECT)) {
+    d->backpressure = (texec_submit_backpressure_info_t){{TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE, NULL}, TEXEC_BACKPRESSURE_CALLER_RUNS};
+    d->has_backpressure = true;
+  }
+
+  if (d->has_priority) { d->priority.header.next = chain; chain = &d->priority; }
+  if (d->has_deadline) { d->deadline.header.next = chain; chain = &d->deadline; }
+  if (d->has_trace_context) { d->trace_context.header.next = chain; chain = &d->trace_context; }
+  if (d->has_backpressure) { d->backpressure.header.next = chain; chain = &d->backpressure; }
+  if (d->has_node) { d->node.header.next = chain; chain = &d->node; }
+  if (d->has_cancel) { d->cancel.header.next = chain; chain = &d->cancel; }
+  if (d->has_context) { d->context.header.next = chain; chain = &d->context; }
+
+  const texec_submit_info_t info = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_INFO, chain},
+    .task = d->task,
+  };
+
+  texec_task_handle_t* h = NULL;
+  const texec_status_t st = ex->vtbl->submit(ex, &info, d->handle ? &h : NULL);
+  texec_task_handle_release(h); // the backend's reference to hand out; d->handle is the same handle
+  return st;
+}
+
+// Drops the record's own references once the task is submitted or given up on.
+static void dependent_finish(dependent_submit_t* d) {
+  texec_task_handle_release(d->handle);
+  if (d->has_cancel) texec_cancel_token_release(d->cancel.token);
+  if (d->group) texec_task_group_leave(d->group, 1);
+  dependent_free(d);
+}
+
+static void dependent_release_from_completion(dependent_submit_t* d) {
+  const texec_status_t st = dependent_submit_now(d, true);
+  if (st != TEXEC_STATUS_OK) {
+    const void* trace_context = d->has_trace_context ? d->trace_context.trace_context : NULL;
+    texec_task_t task = d->task;
+    if (d->has_context) task.ctx = (void*)d->context.data;
+    texec_executor_drop_task(d->ex, &task, trace_context, d->handle, st);
+  }
+  dependent_finish(d);
+}
+
+static void dependent_link_fire(texec_task_handle_continuation_t* c) {
+  dependent_submit_t* d = ((dependent_link_t*)c)->owner;
+  if (atomic_fetch_sub_explicit(&d->pending, 1, memory_order_acq_rel) == 1) {
+    dependent_release_from_completion(d);
+  }
+}
+
+static inline bool dependent_validate(const texec_submit_info_t* info, const texec_submit_dependencies_info_t* deps) {
+  if (!info->task.run) return false;
+  if (deps->count && !deps->handles) return false;
+  for (size_t i = 0; i < deps->count; ++i) {
+    if (!deps->handles[i]) return false;
+  }
+  return true;
+}
+
+static bool dependent_all_done(const texec_submit_dependencies_info_t* deps) {
+  for (size_t i = 0; i < deps->count; ++i) {
+    if (!texec_task_handle_is_done(deps->handles[i])) return false;
+  }
+  return true;
+}
+
+texec_status_t texec_executor_submit_dependent(texec_executor_t* ex,
+                                               const texec_submit_info_t* info,
+                                               const texec_submit_dependencies_info_t* deps,
+                                               texec_task_handle_t** out_handle) {
+  if (out_handle) *out_handle = NULL;
+  if (!info || !dependent_validate(info, deps)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  // Nothing to wait for: an ordinary submit, without the record
+  if (dependent_all_done(deps)) return ex->vtbl->submit(ex, info, out_handle);
+
+  dependent_submit_t* d = texec_allocate(ex->alloc, dependent_size(deps->count), _Alignof(dependent_submit_t));
+  if (!d) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  d->ex = ex;
+  d->task = info->task;
+  atomic_init(&d->pending, deps->count + 1);
+  d->handle = NULL;
+  d->group = texec_executor_find_submit_group(info);
+  d->has_priority = dependent_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_PRIORITY, &d->priority, sizeof(d->priority));
+  d->has_deadline = dependent_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_DEADLINE, &d->deadline, sizeof(d->deadline));
+  d->has_trace_context = dependent_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_TRACE_CONTEXT, &d->trace_context, sizeof(d->trace_context));
+  d->has_backpressure = dependent_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE, &d->backpressure, sizeof(d->backpressure));
+  d->has_node = dependent_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_NODE, &d->node, sizeof(d->node));
+  d->has_cancel = dependent_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_CANCEL, &d->cancel, sizeof(d->cancel));
+  d->has_context = dependent_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_CONTEXT, &d->context, sizeof(d->context));
+  d->link_count = deps->count;
+
+  // The caller's blob is gone by the time the task is submitted: keep a copy to submit from
+  void* context_data = NULL;
+  if (d->has_context && !texec_context_copy_init(&d->context_copy, ex->alloc, &d->context, &context_data)) {
+    d->has_context = false;
+    dependent_free(d);
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+  d->context.data = context_data;
+
+  if (d->group) {
+    const texec_status_t st = texec_task_group_enter(d->group, 1);
+    if (st != TEXEC_STATUS_OK) {
+      dependent_free(d);
+      return st;
+    }
+  }
+
+  if (out_handle) {
+    // One reference for the caller, one for the record
+    texec_task_handle_t* h = texec_executor_create_task_handle(ex, texec_executor_find_submit_payload_size(info));
+    const texec_status_t st = h ? texec_task_handle_retain(h) : TEXEC_STATUS_OUT_OF_MEMORY;
+    if (st != TEXEC_STATUS_OK) {
+      texec_task_handle_destroy(h);
+      if (d->group) texec_task_group_leave(d->group, 1);
+      dependent_free(d);
+      return st;
+    }
+    d->handle = h;
+  }
+
+  if (d->has_cancel && texec_cancel_token_retain(d->cancel.token) != TEXEC_STATUS_OK) d->has_cancel = false;
+
+  // Predecessors that are already done count down right here
+  size_t done = 1;
+  for (size_t i = 0; i < deps->count; ++i) {
+    dependent_link_t* link = &d->links[i];
+    link->owner = d;
+    link->continuation.fire = dependent_link_fire;
+    if (!texec_task_handle_add_continuation(deps->handles[i], &link->continuation)) ++done;
+  }
+
+  // Once the count drops, the last predecessor to complete owns the record and may free it at
+  // any point: `d` must not be touched past the decrement unless it reached zero here
+  texec_task_handle_t* h = d->handle;
+  if (atomic_fetch_sub_explicit(&d->pending, done, memory_order_acq_rel) != done) {
+    if (out_handle) *out_handle = h;
+    return TEXEC_STATUS_OK;
+  }
+
+  // Everything completed while registering: submit on this thread, reporting failures directly
+  const texec_status_t st = dependent_submit_now(d, false);
+  if (st == TEXEC_STATUS_OK) {
+    if (out_handle) *out_handle = h;
+    dependent_finish(d);
+    return st;
+  }
+
+  // Neither the caller nor a backend took the handle; it was never published
+  if (h) texec_task_handle_release(h);
+  dependent_finish(d);
+  return st;
+}
@@ -4,9 +4,13 @@
 
 #include "internal/allocator.h"
 #include "internal/executor.h"
+#include "internal/placement.h"
 
 static const size_t TP_EXECUTOR_DEFAULT_THREAD_COUNT = 1;
 static const size_t TP_EXECUTOR_DEFAULT_QUEUE_CAPACITY = 1024;
+static const size_t EXECUTOR_POOL_DEFAULT_SLAB_CAPACITY = 256;
+static const size_t EXECUTOR_POOL_DEFAULT_THREAD_CACHE_CAPACITY = 64;
+static const uint64_t TP_EXECUTOR_DEFAULT_IDLE_TIMEOUT_NS = 1000000000u;
 
 static inline const texec_executor_create_thread_pool_info_t*
 find_executor_thread_pool_create_info(const texec_executor_create_info_t* info) {
@@ -18,29 +22,173 @@ find_executor_diag_info(const texec_executor_create_info_t* info) {
   return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_DIAGNOSTICS_INFO);
 }
 
-static inline texec_status_t executor_create_thread_pool(const texec_allocator_t* alloc,
-                                                         const texec_diagnostics_t* diag,
-                                                         const texec_executor_create_info_t* info,
-                                                         texec_executor_t** out_ex) {
+static inline const texec_executor_create_pool_info_t*
+find_executor_pool_info(const texec_executor_create_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_POOL_INFO);
+}
+
+static inline const texec_executor_create_deadline_info_t*
+find_executor_deadline_info(const texec_executor_create_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_DEADLINE_INFO);
+}
+
+static inline const texec_executor_create_elastic_info_t*
+find_executor_elastic_info(const texec_executor_create_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_ELASTIC_INFO);
+}
+
+static inline const texec_executor_create_affinity_info_t*
+find_executor_affinity_info(const texec_executor_create_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_AFFINITY_INFO);
+}
+
+static inline const texec_executor_create_idle_info_t*
+find_executor_idle_info(const texec_executor_create_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_EXECUTOR_CREATE_IDLE_INFO);
+}
+
+static inline texec_executor_pool_config_t executor_make_pool_config(const texec_executor_create_info_t* info) {
+  const texec_executor_create_pool_info_t* pool_info = find_executor_pool_info(info);
+  if (!pool_info) return (texec_executor_pool_config_t){0};
+
+  return (texec_executor_pool_config_t){
+    .slab_capacity = pool_info->slab_capacity ? pool_info->slab_capacity : EXECUTOR_POOL_DEFAULT_SLAB_CAPACITY,
+    .thread_cache_capacity = pool_info->thread_cache_capacity ? pool_info->thread_cache_capacity : EXECUTOR_POOL_DEFAULT_THREAD_CACHE_CAPACITY,
+  };
+}
+
+static inline texec_status_t executor_create_inline(const texec_allocator_t* alloc,
+                                                    const texec_diagnostics_t* diag,
+                                                    const texec_executor_create_info_t* info,
+                                                    texec_executor_t** out_ex) {
+  const texec_executor_create_deadline_info_t* deadline_info = find_executor_deadline_info(info);
+
+  texec_inline_executor_config_t cfg = {
+    .alloc = alloc,
+    .diag = diag,
+    .pool = executor_make_pool_config(info),
+    .deadline_policy = deadline_info ? deadline_info->policy : TEXEC_DEADLINE_POLICY_RUN_LATE,
+  };
+
+  // Handles are always pooled so that inline submits do not hit the allocator in steady state
+  if (cfg.pool.slab_capacity == 0) {
+    cfg.pool.slab_capacity = EXECUTOR_POOL_DEFAULT_SLAB_CAPACITY;
+    cfg.pool.thread_cache_capacity = EXECUTOR_POOL_DEFAULT_THREAD_CACHE_CAPACITY;
+  }
+
+  return texec_executor_create_inline(&cfg, out_ex);
+}
+
+static inline texec_status_t executor_make_thread_pool_config(const texec_allocator_t* alloc,
+                                                              const texec_diagnostics_t* diag,
+                                                              const texec_executor_create_info_t* info,
+                                                              texec_thread_pool_executor_config_t* out_cfg) {
   const texec_executor_create_thread_pool_info_t* tp_info = find_executor_thread_pool_create_info(info);
   if (!tp_info) return TEXEC_STATUS_INVALID_ARGUMENT;
 
-  const texec_thread_pool_executor_config_t cfg = {
+  const texec_executor_create_deadline_info_t* deadline_info = find_executor_deadline_info(info);
+  const texec_executor_create_idle_info_t* idle_info = find_executor_idle_info(info);
+
+  *out_cfg = (texec_thread_pool_executor_config_t){
     .alloc = alloc,
     .diag = diag,
     .thread_count = tp_info->thread_count ? tp_info->thread_count : TP_EXECUTOR_DEFAULT_THREAD_COUNT,
     .queue_capacity = tp_info->queue_capacity ? tp_info->queue_capacity : TP_EXECUTOR_DEFAULT_QUEUE_CAPACITY,
-    .backpressure = tp_info->backpressure
+    .backpressure = tp_info->backpressure,
+    .pool = executor_make_pool_config(info),
+    .deadline_policy = deadline_info ? deadline_info->policy : TEXEC_DEADLINE_POLICY_RUN_LATE,
+    .affinity = find_executor_affinity_info(info),
+    .spin_count = idle_info ? idle_info->spin_count : 0,
+    .yield_count = idle_info ? idle_info->yield_count : 0,
   };
 
+  // Sized to the CPUs the pool may use, if they can be determined
+  if (out_cfg->affinity && out_cfg->affinity->size_to_cpus) {
+    const size_t cpus = texec_placement_usable_cpu_count(out_cfg->affinity);
+    if (cpus) out_cfg->thread_count = cpus;
+  }
+  out_cfg->min_thread_count = out_cfg->thread_count;
+
+  return TEXEC_STATUS_OK;
+}
+
+// Applies a texec_executor_create_elastic_info_t, if chained, on top of the fixed-size config.
+static inline texec_status_t executor_apply_elastic_config(const texec_executor_create_info_t* info,
+                                                           texec_thread_pool_executor_config_t* cfg) {
+  const texec_executor_create_elastic_info_t* elastic = find_executor_elastic_info(info);
+  if (!elastic) return TEXEC_STATUS_OK;
+
+  if (elastic->min_threads == 0 || elastic->max_threads < elastic->min_threads) {
+    return TEXEC_STATUS_INVALID_ARGUMENT;
+  }
+
+  cfg->min_thread_count = elastic->min_threads;
+  cfg->thread_count = elastic->max_threads;
+  if (cfg->affinity && cfg->affinity->size_to_cpus) {
+    const size_t cpus = texec_placement_usable_cpu_count(cfg->affinity);
+    if (cpus && cpus < cfg->thread_count) {
+      cfg->thread_count = cpus > cfg->min_thread_count ? cpus : cfg->min_thread_count;
+    }
+  }
+  cfg->idle_timeout_ns = elastic->idle_timeout_ns ? elastic->idle_timeout_ns : TP_EXECUTOR_DEFAULT_IDLE_TIMEOUT_NS;
+  cfg->grow_queue_depth = elastic->grow_queue_depth ? elastic->grow_queue_depth : 1;
+  cfg->grow_sojourn_ns = elastic->grow_sojourn_ns;
+  return TEXEC_STATUS_OK;
+}
+
+static inline texec_status_t executor_create_thread_pool(const texec_allocator_t* alloc,
+                                                         const texec_diagnostics_t* diag,
+                                                         const texec_executor_create_info_t* info,
+                                                         texec_executor_t** out_ex) {
+  texec_thread_pool_executor_config_t cfg;
+  texec_status_t st = executor_make_thread_pool_config(alloc, diag, info, &cfg);
+  if (st != TEXEC_STATUS_OK) return st;
+  st = executor_apply_elastic_config(info, &cfg);
+  if (st != TEXEC_STATUS_OK) return st;
   return texec_executor_create_thread_pool(&cfg, out_ex);
 }
 
+static inline texec_status_t executor_create_work_stealing(const texec_allocator_t* alloc,
+                                                           const texec_diagnostics_t* diag,
+                                                           const texec_executor_create_info_t* info,
+                                                           texec_executor_t** out_ex) {
+  texec_thread_pool_executor_config_t cfg;
+  texec_status_t st = executor_make_thread_pool_config(alloc, diag, info, &cfg);
+  if (st != TEXEC_STATUS_OK) return st;
+  return texec_executor_create_work_stealing(&cfg, out_ex);
+}
+
+texec_status_t texec_executor_init_pools(texec_executor_t* ex, const texec_executor_pool_config_t* cfg) {
+  ex->work_item_pool = NULL;
+  ex->handle_pool = NULL;
+
+  if (!cfg || cfg->slab_capacity == 0) return TEXEC_STATUS_OK;
+
+  texec_status_t st = texec_work_item_pool_create(ex->alloc, cfg->slab_capacity, cfg->thread_cache_capacity, &ex->work_item_pool);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  st = texec_task_handle_pool_create(ex->alloc, cfg->slab_capacity, cfg->thread_cache_capacity, &ex->handle_pool);
+  if (st != TEXEC_STATUS_OK) {
+    texec_executor_release_pools(ex);
+    return st;
+  }
+
+  return TEXEC_STATUS_OK;
+}
+
+void texec_executor_release_pools(texec_executor_t* ex) {
+  texec_object_pool_release(ex->work_item_pool);
+  texec_object_pool_release(ex->handle_pool);
+  ex->work_item_pool = NULL;
+  ex->handle_pool = NULL;
+}
+
 static inline bool executor_validate(const texec_executor_t* ex) {
   return ex
     && ex->alloc
     && ex->vtbl
     && ex->vtbl->submit
+    && ex->vtbl->submit_intrusive
     && ex->vtbl->submit_many
     && ex->vtbl->close
     && ex->vtbl->join
@@ -66,9 +214,15 @@ texec_status_t texec_executor_create(const texec_executor_create_info_t* info, c
 
   texec_status_t st = TEXEC_STATUS_UNSUPPORTED;
   switch (info->kind) {
+  case TEXEC_EXECUTOR_KIND_INLINE:
+    st = executor_create_inline(alloc, diag, info, out_executor);
+    break;
   case TEXEC_EXECUTOR_KIND_THREAD_POOL:
     st = executor_create_thread_pool(alloc, diag, info, out_executor);
     break;
+  case TEXEC_EXECUTOR_KIND_WORK_STEALING:
+    st = executor_create_work_stealing(alloc, diag, info, out_executor);
+    break;
   default:
     break;
   }
@@ -90,23 +244,52 @@ texec_status_t texec_executor_destroy(texec_executor_t* ex) {
   return ex->vtbl->destroy(ex);
 }
 
+static inline bool executor_validate_submit_context(const texec_submit_info_t* info) {
+  const texec_submit_context_info_t* ci = texec_executor_find_submit_context(info);
+  return !ci || !ci->size || ci->data;
+}
+
 texec_status_t texec_executor_submit(texec_executor_t* ex, const texec_submit_info_t* info, texec_task_handle_t** out_handle) {
-  if (!ex || !out_handle) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (!ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (info && texec_executor_find_submit_payload_size(info) > TEXEC_SUBMIT_RESULT_PAYLOAD_MAX) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (info && !executor_validate_submit_context(info)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  const texec_submit_dependencies_info_t* deps = info ? texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_DEPENDENCIES) : NULL;
+  if (deps) return texec_executor_submit_dependent(ex, info, deps, out_handle);
+
   return ex->vtbl->submit(ex, info, out_handle);
 }
 
+texec_status_t texec_executor_submit_intrusive(texec_executor_t* ex, const texec_submit_intrusive_info_t* info) {
+  if (!ex || !info || info->header.type != TEXEC_STRUCT_TYPE_SUBMIT_INTRUSIVE_INFO) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (!info->task || !info->task->task.run) return TEXEC_STATUS_INVALID_ARGUMENT;
+  return ex->vtbl->submit_intrusive(ex, info);
+}
+
 texec_status_t texec_executor_submit_many(texec_executor_t* ex, const texec_submit_info_t* infos, size_t count, texec_task_group_t** out_group) {
   if (!ex || !out_group) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  for (size_t i = 0; infos && i < count; ++i) {
+    if (texec_structure_find(infos[i].header.next, TEXEC_STRUCT_TYPE_SUBMIT_DEPENDENCIES) || !executor_validate_submit_context(&infos[i])) {
+      *out_group = NULL;
+      return TEXEC_STATUS_INVALID_ARGUMENT;
+    }
+  }
+
   return ex->vtbl->submit_many(ex, infos, count, out_group);
 }
 
 void texec_executor_close(texec_executor_t* ex) {
   if (!ex) return;
+  texec_executor_close_timers(ex);
   ex->vtbl->close(ex);
 }
 
 void texec_executor_join(texec_executor_t* ex) {
   if (!ex) return;
+  // The timer thread submits into the executor, so it goes first
+  texec_executor_join_timers(ex);
   ex->vtbl->join(ex);
 }
 
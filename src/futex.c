@@ -0,0 +1,127 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "internal/futex.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__linux__)
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <errno.h>
+
+static inline long futex_call(atomic_uint* addr, int op, unsigned int val, const struct timespec* timeout) {
+  return syscall(SYS_futex, (unsigned int*)addr, op, val, timeout, NULL, 0);
+}
+
+void texec_futex_wait(atomic_uint* addr, unsigned int expected) {
+  futex_call(addr, FUTEX_WAIT_PRIVATE, expected, NULL);
+}
+
+bool texec_futex_wait_timeout(atomic_uint* addr, unsigned int expected, uint64_t timeout_ns) {
+  // FUTEX_WAIT takes a relative timeout measured against CLOCK_MONOTONIC
+  const struct timespec ts = {
+    .tv_sec = (time_t)(timeout_ns / 1000000000u),
+    .tv_nsec = (long)(timeout_ns % 1000000000u),
+  };
+  return futex_call(addr, FUTEX_WAIT_PRIVATE, expected, &ts) == 0 || errno != ETIMEDOUT;
+}
+
+void texec_futex_wake_one(atomic_uint* addr) {
+  futex_call(addr, FUTEX_WAKE_PRIVATE, 1u, NULL);
+}
+
+void texec_futex_wake_many(atomic_uint* addr, unsigned int count) {
+  futex_call(addr, FUTEX_WAKE_PRIVATE, count < (unsigned int)INT_MAX ? count : (unsigned int)INT_MAX, NULL);
+}
+
+void texec_futex_wake_all(atomic_uint* addr) {
+  futex_call(addr, FUTEX_WAKE_PRIVATE, (unsigned int)INT_MAX, NULL);
+}
+
+#else
+
+#include <threads.h>
+
+// Global parking lot: waiters hash their address onto a bucket and sleep on its condvar.
+// Wakers always broadcast since unrelated addresses may share a bucket.
+
+#define PARKING_LOT_BUCKET_COUNT 64
+
+typedef struct parking_bucket {
+  mtx_t mtx;
+  cnd_t cv;
+} parking_bucket_t;
+
+static parking_bucket_t parking_lot[PARKING_LOT_BUCKET_COUNT];
+static once_flag parking_lot_once = ONCE_FLAG_INIT;
+
+static void parking_lot_init(void) {
+  for (size_t i = 0; i < PARKING_LOT_BUCKET_COUNT; ++i) {
+    mtx_init(&parking_lot[i].mtx, mtx_plain);
+    cnd_init(&parking_lot[i].cv);
+  }
+}
+
+static inline parking_bucket_t* parking_lot_bucket(const void* addr) {
+  call_once(&parking_lot_once, &parking_lot_init);
+  uintptr_t h = (uintptr_t)addr;
+  h ^= h >> 17;
+  h *= (uintptr_t)0x9E3779B97F4A7C15ull;
+  return &parking_lot[(h >> 7) % PARKING_LOT_BUCKET_COUNT];
+}
+
+void texec_futex_wait(atomic_uint* addr, unsigned int expected) {
+  parking_bucket_t* b = parking_lot_bucket(addr);
+  mtx_lock(&b->mtx);
+  if (atomic_load_explicit(addr, memory_order_seq_cst) == expected) {
+    cnd_wait(&b->cv, &b->mtx);
+  }
+  mtx_unlock(&b->mtx);
+}
+
+bool texec_futex_wait_timeout(atomic_uint* addr, unsigned int expected, uint64_t timeout_ns) {
+  // cnd_timedwait takes an absolute TIME_UTC deadline
+  struct timespec deadline;
+  timespec_get(&deadline, TIME_UTC);
+  const uint64_t nsec = (uint64_t)deadline.tv_nsec + timeout_ns % 1000000000u;
+  deadline.tv_sec += (time_t)(timeout_ns / 1000000000u + nsec / 1000000000u);
+  deadline.tv_nsec = (long)(nsec % 1000000000u);
+
+  bool woken = true;
+  parking_bucket_t* b = parking_lot_bucket(addr);
+  mtx_lock(&b->mtx);
+  if (atomic_load_explicit(addr, memory_order_seq_cst) == expected) {
+    woken = cnd_timedwait(&b->cv, &b->mtx, &deadline) != thrd_timedout;
+  }
+  mtx_unlock(&b->mtx);
+  return woken;
+}
+
+static inline void parking_lot_wake(const void* addr) {
+  parking_bucket_t* b = parking_lot_bucket(addr);
+  mtx_lock(&b->mtx);
+  cnd_broadcast(&b->cv);
+  mtx_unlock(&b->mtx);
+}
+
+void texec_futex_wake_one(atomic_uint* addr) {
+  parking_lot_wake(addr);
+}
+
+void texec_futex_wake_many(atomic_uint* addr, unsigned int count) {
+  (void)count;
+  parking_lot_wake(addr);
+}
+
+void texec_futex_wake_all(atomic_uint* addr) {
+  parking_lot_wake(addr);
+}
+
+#endif
@@ -0,0 +1,36 @@
+#include "internal/help.h"
+
+#include <stddef.h>
+
+#include "texec/clock.h"
+
+#include "internal/futex.h"
+
+static _Thread_local const texec_helper_t* help_current = NULL;
+
+void texec_help_install(const texec_helper_t* helper) {
+  help_current = helper;
+}
+
+bool texec_help_run_one(uint64_t deadline_ns) {
+  const texec_helper_t* helper = help_current;
+  if (!helper) return false;
+  if (deadline_ns != UINT64_MAX && texec_clock_now_ns() >= deadline_ns) return false;
+  return helper->run_one(helper->worker);
+}
+
+bool texec_help_park(atomic_uint* word, unsigned int expected, uint64_t deadline_ns) {
+  const bool helping = help_current != NULL;
+  if (deadline_ns == UINT64_MAX && !helping) {
+    texec_futex_wait(word, expected);
+    return true;
+  }
+
+  const uint64_t now = texec_clock_now_ns();
+  if (now >= deadline_ns) return false;
+
+  uint64_t timeout_ns = deadline_ns - now;
+  if (helping && timeout_ns > TEXEC_HELP_PARK_NS) timeout_ns = TEXEC_HELP_PARK_NS;
+  texec_futex_wait_timeout(word, expected, timeout_ns);
+  return true;
+}
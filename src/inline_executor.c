@@ -0,0 +1,321 @@
+#include "internal/executor.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "texec/clock.h"
+#include "texec/task_group.h"
+#include "internal/task_handle.h"
+
+// Runs every task on the submitting thread, inside submit. Tasks never become work items: the
+// task is run straight from the caller's texec_submit_info_t, so a detached submit allocates
+// nothing and a submit with a handle only draws one from the handle pool.
+typedef struct inline_executor {
+  texec_executor_t base;
+  atomic_bool closed; // submits may come from any thread
+  texec_deadline_policy_t deadline_policy;
+  atomic_uint_least64_t expired_count;
+} inline_executor_t;
+
+static inline bool inline_is_inline(const texec_executor_t* ex) {
+  return ex && ex->kind == TEXEC_EXECUTOR_KIND_INLINE;
+}
+
+static inline inline_executor_t* inline_from_base(texec_executor_t* ex) {
+  if (!inline_is_inline(ex)) {
+    return NULL;
+  }
+  return (inline_executor_t*)ex;
+}
+
+static inline const inline_executor_t* inline_from_const_base(const texec_executor_t* ex) {
+  if (!inline_is_inline(ex)) {
+    return NULL;
+  }
+  return (const inline_executor_t*)ex;
+}
+
+static inline bool inline_is_closed(const inline_executor_t* ex) {
+  return atomic_load_explicit(&ex->closed, memory_order_acquire);
+}
+
+static inline bool inline_validate_submit_info(const texec_submit_info_t* info) {
+  if (!info || info->header.type != TEXEC_STRUCT_TYPE_SUBMIT_INFO || !info->task.run) return false;
+
+  // Priorities have no effect inline but are validated like on the pools
+  const texec_submit_priority_info_t* pi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_PRIORITY);
+  if (!pi) return true;
+
+  return pi->priority == TEXEC_SUBMIT_PRIORITY_LOW
+      || pi->priority == TEXEC_SUBMIT_PRIORITY_NORMAL
+      || pi->priority == TEXEC_SUBMIT_PRIORITY_HIGH;
+}
+
+static inline const void* inline_resolve_trace_context(const texec_submit_info_t* info) {
+  const texec_submit_trace_context_info_t* tci = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_TRACE_CONTEXT);
+  return tci ? tci->trace_context : NULL;
+}
+
+// A deadline can only have passed already at submit time; it is checked against the drop policy.
+static inline bool inline_is_expired(const inline_executor_t* ex, const texec_submit_info_t* info) {
+  if (ex->deadline_policy != TEXEC_DEADLINE_POLICY_DROP_EXPIRED) return false;
+
+  const texec_submit_deadline_info_t* dli = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_DEADLINE);
+  return dli && texec_clock_now_ns() > dli->deadline_ns;
+}
+
+static inline bool inline_is_cancelled(const texec_submit_info_t* info, const texec_task_group_t* group) {
+  return texec_cancel_token_is_cancelled(texec_executor_find_submit_cancel_token(info, group));
+}
+
+// Runs (or drops) the task of `info`. `group`, if any, must already count the task.
+static void inline_execute(inline_executor_t* ex, const texec_submit_info_t* info, texec_task_handle_t* h, texec_task_group_t* group) {
+  const void* trace_context = inline_resolve_trace_context(info);
+
+  // A context blob is copied like on the pools, so the task sees the same thing everywhere
+  texec_task_t task = info->task;
+  texec_context_copy_t context_copy;
+  context_copy.heap = NULL;
+  const texec_submit_context_info_t* context = texec_executor_find_submit_context(info);
+
+  if (context && !texec_context_copy_init(&context_copy, ex->base.alloc, context, &task.ctx)) {
+    texec_executor_drop_task(&ex->base, &task, trace_context, h, TEXEC_STATUS_OUT_OF_MEMORY);
+  } else if (inline_is_cancelled(info, group)) {
+    texec_executor_drop_task(&ex->base, &task, trace_context, h, TEXEC_STATUS_CANCELLED);
+  } else if (inline_is_expired(ex, info)) {
+    atomic_fetch_add_explicit(&ex->expired_count, 1, memory_order_relaxed);
+    texec_executor_drop_task(&ex->base, &task, trace_context, h, TEXEC_STATUS_EXPIRED);
+  } else {
+    texec_executor_run_task(&ex->base, &task, trace_context, h, group);
+  }
+  texec_context_copy_release(&context_copy, ex->base.alloc);
+
+  if (group) {
+    texec_task_group_leave(group, 1);
+  }
+}
+
+static texec_status_t inline_vtbl_submit(texec_executor_t* ex, const texec_submit_info_t* info, texec_task_handle_t** out_handle) {
+  if (out_handle) *out_handle = NULL;
+
+  inline_executor_t* in_ex = inline_from_base(ex);
+  if (!in_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (!inline_validate_submit_info(info)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (inline_is_closed(in_ex)) return TEXEC_STATUS_CLOSED;
+
+  texec_task_handle_t* h = NULL;
+  if (out_handle) {
+    h = texec_executor_create_submit_handle(ex, info);
+    if (!h) return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+
+  texec_task_group_t* group = texec_executor_find_submit_group(info);
+  if (group) {
+    texec_status_t st = texec_task_group_enter(group, 1);
+    if (st != TEXEC_STATUS_OK) {
+      texec_task_handle_release(h);
+      return st;
+    }
+  }
+
+  inline_execute(in_ex, info, h, group);
+
+  if (out_handle) *out_handle = h;
+  return TEXEC_STATUS_OK;
+}
+
+static texec_status_t inline_vtbl_submit_intrusive(texec_executor_t* ex, const texec_submit_intrusive_info_t* info) {
+  inline_executor_t* in_ex = inline_from_base(ex);
+  if (!in_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  // Validated and checked for expiry through the extension chain, like a regular submit
+  const texec_submit_info_t chain = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_INFO, info->header.next},
+    .task = info->task->task,
+  };
+  if (!inline_validate_submit_info(&chain)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (inline_is_closed(in_ex)) return TEXEC_STATUS_CLOSED;
+
+  texec_work_item_t* wi = texec_work_item_from_intrusive(info->task);
+  if (inline_is_expired(in_ex, &chain)) {
+    atomic_fetch_add_explicit(&in_ex->expired_count, 1, memory_order_relaxed);
+    texec_executor_drop_work_item(ex, wi, TEXEC_STATUS_EXPIRED);
+  } else {
+    texec_executor_consume_work_item(ex, wi);
+  }
+  return TEXEC_STATUS_OK;
+}
+
+static texec_status_t inline_vtbl_submit_many(texec_executor_t* ex, const texec_submit_info_t* infos, size_t count, texec_task_group_t** out_group) {
+  if (!out_group) return TEXEC_STATUS_INVALID_ARGUMENT;
+  *out_group = NULL;
+
+  inline_executor_t* in_ex = inline_from_base(ex);
+  if (!in_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (count && !infos) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  for (size_t i = 0; i < count; ++i) {
+    if (!inline_validate_submit_info(&infos[i])) return TEXEC_STATUS_INVALID_ARGUMENT;
+  }
+
+  // Tasks are only counted by the group, no per-task handles
+  const texec_task_group_create_info_t gi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_INFO, .next = NULL},
+    .capacity = 0,
+  };
+
+  texec_task_group_t* g = NULL;
+  texec_status_t st = texec_task_group_create(&gi, ex->alloc, &g);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  if (count == 0) {
+    *out_group = g;
+    return TEXEC_STATUS_OK;
+  }
+
+  st = inline_is_closed(in_ex) ? TEXEC_STATUS_CLOSED : texec_task_group_enter(g, count);
+  if (st != TEXEC_STATUS_OK) {
+    texec_task_group_destroy(g);
+    return st;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    inline_execute(in_ex, &infos[i], NULL, g);
+  }
+
+  *out_group = g;
+  return TEXEC_STATUS_OK;
+}
+
+static void inline_vtbl_close(texec_executor_t* ex) {
+  inline_executor_t* in_ex = inline_from_base(ex);
+  if (!in_ex) return;
+
+  atomic_store_explicit(&in_ex->closed, true, memory_order_release);
+  if (in_ex->base.state == TEXEC_EXECUTOR_STATE_RUNNING) {
+    in_ex->base.state = TEXEC_EXECUTOR_STATE_CLOSING;
+  }
+}
+
+// Nothing is ever queued: every accepted task has finished by the time its submit returned.
+static void inline_vtbl_join(texec_executor_t* ex) {
+  inline_executor_t* in_ex = inline_from_base(ex);
+  if (!in_ex) return;
+
+  inline_vtbl_close(ex);
+  in_ex->base.state = TEXEC_EXECUTOR_STATE_CLOSED;
+}
+
+static void inline_free(inline_executor_t* ex) {
+  texec_free(ex->base.alloc, ex, sizeof(*ex), _Alignof(inline_executor_t));
+}
+
+static texec_status_t inline_vtbl_destroy(texec_executor_t* ex) {
+  inline_executor_t* in_ex = inline_from_base(ex);
+  if (!in_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (in_ex->base.state != TEXEC_EXECUTOR_STATE_CLOSED) return TEXEC_STATUS_BUSY;
+
+  texec_executor_release_timers(&in_ex->base);
+  texec_executor_release_pools(&in_ex->base);
+  inline_free(in_ex);
+  return TEXEC_STATUS_OK;
+}
+
+static texec_status_t inline_vtbl_query(const texec_executor_t* ex, texec_executor_capability_t cap, void* out_value) {
+  if (!out_value) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  const inline_executor_t* in_ex = inline_from_const_base(ex);
+  if (!in_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  switch (cap) {
+  case TEXEC_EXECUTOR_CAPABILITY_WORKER_COUNT:
+    *(size_t*)out_value = 0; // tasks run on the submitting thread
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_PRIORITY:
+    *(bool*)out_value = false;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_DEADLINE:
+    *(bool*)out_value = true;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_EXPIRED_COUNT:
+    *(uint64_t*)out_value = atomic_load_explicit(&in_ex->expired_count, memory_order_relaxed);
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_TRACING:
+    *(bool*)out_value = true;
+    return TEXEC_STATUS_OK;
+
+  // No workers to report on, and nothing is ever queued or rejected
+  case TEXEC_EXECUTOR_CAPABILITY_METRICS:
+    *(texec_executor_metrics_t*)out_value = (texec_executor_metrics_t){0};
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_WORKER_METRICS:
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_LIVE_WORKER_COUNT:
+  case TEXEC_EXECUTOR_CAPABILITY_IDLE_WORKER_COUNT:
+    *(size_t*)out_value = 0;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_NODE_COUNT:
+    *(size_t*)out_value = 1;
+    return TEXEC_STATUS_OK;
+
+  default:
+    break;
+  }
+
+  return TEXEC_STATUS_INVALID_ARGUMENT;
+}
+
+texec_status_t texec_executor_create_inline(const texec_inline_executor_config_t* cfg, texec_executor_t** out_ex) {
+  if (!out_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+  *out_ex = NULL;
+
+  if (!cfg) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  inline_executor_t* in_ex = texec_allocate(cfg->alloc, sizeof(*in_ex), _Alignof(inline_executor_t));
+  if (!in_ex) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  static const texec_executor_vtable_t vtbl_instance = {
+    .submit = inline_vtbl_submit,
+    .submit_intrusive = inline_vtbl_submit_intrusive,
+    .submit_many = inline_vtbl_submit_many,
+    .close = inline_vtbl_close,
+    .join = inline_vtbl_join,
+    .destroy = inline_vtbl_destroy,
+    .query = inline_vtbl_query,
+  };
+
+  in_ex->base.vtbl = &vtbl_instance;
+  in_ex->base.alloc = cfg->alloc;
+  in_ex->base.diag = cfg->diag;
+  in_ex->base.work_item_pool = NULL;
+  in_ex->base.handle_pool = NULL;
+  atomic_init(&in_ex->base.timers, NULL);
+  in_ex->base.kind = TEXEC_EXECUTOR_KIND_INLINE;
+  in_ex->base.state = TEXEC_EXECUTOR_STATE_RUNNING;
+  atomic_init(&in_ex->closed, false);
+  in_ex->deadline_policy = cfg->deadline_policy;
+  atomic_init(&in_ex->expired_count, 0);
+
+  if (cfg->pool.slab_capacity) {
+    texec_status_t st = texec_task_handle_pool_create(cfg->alloc, cfg->pool.slab_capacity, cfg->pool.thread_cache_capacity, &in_ex->base.handle_pool);
+    if (st != TEXEC_STATUS_OK) {
+      inline_free(in_ex);
+      return st;
+    }
+  }
+
+  *out_ex = (texec_executor_t*)in_ex;
+  return TEXEC_STATUS_OK;
+}
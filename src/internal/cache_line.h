@@ -0,0 +1,6 @@
+#pragma once
+
+#define TEXEC_CACHE_LINE_SIZE 64
+
+// Aligns (and therefore pads) a member to its own cache line to avoid false sharing.
+#define TEXEC_CACHE_ALIGNED _Alignas(TEXEC_CACHE_LINE_SIZE)
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "texec/executor_submit_info.h"
+
+#include "internal/allocator.h"
+
+// Copy of a submit's context blob (texec_submit_context_info_t) that outlives the caller's:
+// inline up to TEXEC_SUBMIT_CONTEXT_INLINE_MAX bytes, from the allocator beyond.
+typedef struct texec_context_copy {
+  void* heap; // NULL while the copy is inline
+  size_t size;
+  _Alignas(max_align_t) unsigned char storage[TEXEC_SUBMIT_CONTEXT_INLINE_MAX];
+} texec_context_copy_t;
+
+// Copies the blob of `info` into `c` and points *out_ctx at the copy, NULL for an empty blob.
+// Returns false, leaving nothing to release, if the allocator fails.
+static inline bool texec_context_copy_init(texec_context_copy_t* c, const texec_allocator_t* alloc, const texec_submit_context_info_t* info, void** out_ctx) {
+  void* dst = c->storage;
+  c->heap = NULL;
+  c->size = info->size;
+  if (info->size > TEXEC_SUBMIT_CONTEXT_INLINE_MAX) {
+    dst = c->heap = texec_allocate(alloc, info->size, _Alignof(max_align_t));
+    if (!dst) return false;
+  }
+  if (info->size) memcpy(dst, info->data, info->size);
+  *out_ctx = info->size ? dst : NULL;
+  return true;
+}
+
+static inline void texec_context_copy_release(texec_context_copy_t* c, const texec_allocator_t* alloc) {
+  if (c->heap) texec_free(alloc, c->heap, c->size, _Alignof(max_align_t));
+  c->heap = NULL;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "texec/base.h"
+
+// Bounded binary min-heap keyed by deadline; equal deadlines pop in push order.
+// Not synchronized: callers hold their own lock.
+
+typedef struct texec_deadline_heap_entry {
+  uint64_t deadline_ns;
+  uint64_t seq;
+  uintptr_t item;
+} texec_deadline_heap_entry_t;
+
+typedef struct texec_deadline_heap {
+  texec_deadline_heap_entry_t* entries;
+  size_t count;
+  size_t capacity;
+  uint64_t next_seq;
+  const texec_allocator_t* alloc;
+} texec_deadline_heap_t;
+
+texec_status_t texec_deadline_heap_init(texec_deadline_heap_t* h, size_t capacity, const texec_allocator_t* alloc);
+void texec_deadline_heap_destroy(texec_deadline_heap_t* h);
+
+// Returns false when the heap is full.
+bool texec_deadline_heap_push(texec_deadline_heap_t* h, uint64_t deadline_ns, uintptr_t item);
+
+// Removes the entry with the earliest deadline. Returns false when the heap is empty.
+bool texec_deadline_heap_pop(texec_deadline_heap_t* h, uint64_t* out_deadline_ns, uintptr_t* out_item);
+
+static inline bool texec_deadline_heap_is_full(const texec_deadline_heap_t* h) {
+  return h->count == h->capacity;
+}
@@ -16,3 +16,8 @@ static inline void texec_diagnostics_on_task_end(const texec_diagnostics_t* diag
   if (!diag) return;
   diag->on_task_end(diag->user, task, trace_context, task_result);
 }
+
+static inline void texec_diagnostics_on_task_dropped(const texec_diagnostics_t* diag, const struct texec_task* task, const void* trace_context, texec_status_t reason) {
+  if (!diag || !diag->on_task_dropped) return;
+  diag->on_task_dropped(diag->user, task, trace_context, reason);
+}
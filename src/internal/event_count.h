@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "texec/clock.h"
+#include "internal/futex.h"
+
+// Eventcount: lets consumers sleep on "some condition became true" without the
+// producers taking a lock. Producers only pay a fence and a load while nobody waits.
+//
+// Consumer:
+//   key = prepare_wait(ec);
+//   if (condition) { cancel_wait(ec); ... } else { wait(ec, key); }
+// Producer:
+//   make condition true; notify_one(ec) / notify_all(ec);
+
+typedef struct texec_event_count {
+  atomic_uint epoch;
+  atomic_uint waiters;
+} texec_event_count_t;
+
+static inline void texec_event_count_init(texec_event_count_t* ec) {
+  atomic_init(&ec->epoch, 0u);
+  atomic_init(&ec->waiters, 0u);
+}
+
+static inline unsigned int texec_event_count_prepare_wait(texec_event_count_t* ec) {
+  atomic_fetch_add_explicit(&ec->waiters, 1u, memory_order_seq_cst);
+  return atomic_load_explicit(&ec->epoch, memory_order_seq_cst);
+}
+
+static inline void texec_event_count_cancel_wait(texec_event_count_t* ec) {
+  atomic_fetch_sub_explicit(&ec->waiters, 1u, memory_order_relaxed);
+}
+
+static inline void texec_event_count_wait(texec_event_count_t* ec, unsigned int key) {
+  while (atomic_load_explicit(&ec->epoch, memory_order_seq_cst) == key) {
+    texec_futex_wait(&ec->epoch, key);
+  }
+  atomic_fetch_sub_explicit(&ec->waiters, 1u, memory_order_relaxed);
+}
+
+// Like wait, but gives up at `deadline_ns` (texec_clock_now_ns() clock). Returns false if it
+// timed out without being notified.
+static inline bool texec_event_count_wait_until(texec_event_count_t* ec, unsigned int key, uint64_t deadline_ns) {
+  bool notified = true;
+  while (atomic_load_explicit(&ec->epoch, memory_order_seq_cst) == key) {
+    const uint64_t now = texec_clock_now_ns();
+    if (now >= deadline_ns) {
+      notified = false;
+      break;
+    }
+    texec_futex_wait_timeout(&ec->epoch, key, deadline_ns - now);
+  }
+  atomic_fetch_sub_explicit(&ec->waiters, 1u, memory_order_relaxed);
+  return notified;
+}
+
+static inline bool texec_event_count_has_waiters(texec_event_count_t* ec) {
+  atomic_thread_fence(memory_order_seq_cst);
+  return atomic_load_explicit(&ec->waiters, memory_order_relaxed) != 0u;
+}
+
+static inline void texec_event_count_notify_one(texec_event_count_t* ec) {
+  if (!texec_event_count_has_waiters(ec)) return;
+  atomic_fetch_add_explicit(&ec->epoch, 1u, memory_order_seq_cst);
+  texec_futex_wake_one(&ec->epoch);
+}
+
+// Wakes up to `count` waiters.
+static inline void texec_event_count_notify_many(texec_event_count_t* ec, unsigned int count) {
+  if (count == 0 || !texec_event_count_has_waiters(ec)) return;
+  atomic_fetch_add_explicit(&ec->epoch, 1u, memory_order_seq_cst);
+  texec_futex_wake_many(&ec->epoch, count);
+}
+
+static inline void texec_event_count_notify_all(texec_event_count_t* ec) {
+  if (!texec_event_count_has_waiters(ec)) return;
+  atomic_fetch_add_explicit(&ec->epoch, 1u, memory_order_seq_cst);
+  texec_futex_wake_all(&ec->epoch);
+}
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <stdatomic.h>
+
 #include "texec/executor.h"
 #include "texec/task.h"
 #include "texec/task_handle.h"
 
 #include "internal/allocator.h"
 #include "internal/diagnostics.h"
+#include "internal/object_pool.h"
+#include "internal/task_group.h"
 #include "internal/task_handle.h"
+#include "internal/timer.h"
 #include "internal/work_item.h"
 
 typedef enum texec_executor_state {
@@ -16,6 +21,7 @@ typedef enum texec_executor_state {
 } texec_executor_state_t;
 
 typedef texec_status_t (*texec_executor_submit_fn_t)(texec_executor_t* ex,  const texec_submit_info_t* info, texec_task_handle_t** out_handle);
+typedef texec_status_t (*texec_executor_submit_intrusive_fn_t)(texec_executor_t* ex, const texec_submit_intrusive_info_t* info);
 typedef texec_status_t (*texec_executor_submit_many_fn_t)(texec_executor_t* ex, const texec_submit_info_t* infos, size_t count, texec_task_group_t** out_group);
 typedef void (*texec_executor_close_fn_t)(texec_executor_t* ex);
 typedef void (*texec_executor_join_fn_t)(texec_executor_t* ex);
@@ -24,6 +30,7 @@ typedef texec_status_t (*texec_executor_query_fn_t)(const texec_executor_t* ex,
 
 typedef struct texec_executor_vtable {
   texec_executor_submit_fn_t submit;
+  texec_executor_submit_intrusive_fn_t submit_intrusive;
   texec_executor_submit_many_fn_t submit_many;
   texec_executor_close_fn_t close;
   texec_executor_join_fn_t join;
@@ -35,30 +42,176 @@ struct texec_executor {
   const texec_executor_vtable_t* vtbl;
   const texec_allocator_t* alloc;
   const texec_diagnostics_t* diag;
+  texec_object_pool_t* work_item_pool; // optional
+  texec_object_pool_t* handle_pool;    // optional
   texec_executor_kind_t kind;
   texec_executor_state_t state;
+  _Atomic(texec_timer_service_t*) timers; // NULL until the first texec_executor_schedule
 };
 
+typedef struct texec_executor_pool_config {
+  size_t slab_capacity; // 0 disables pooling
+  size_t thread_cache_capacity;
+} texec_executor_pool_config_t;
+
 typedef struct texec_thread_pool_executor_config {
   const texec_allocator_t* alloc;
   const texec_diagnostics_t* diag;
   size_t thread_count;
   size_t queue_capacity;
   texec_backpressure_policy_t backpressure;
+  texec_executor_pool_config_t pool;
+  texec_deadline_policy_t deadline_policy;
+  size_t min_thread_count; // == thread_count unless the pool is elastic
+  uint64_t idle_timeout_ns;
+  size_t grow_queue_depth;
+  uint64_t grow_sojourn_ns;
+  const texec_executor_create_affinity_info_t* affinity; // optional
+  uint32_t spin_count;
+  uint32_t yield_count;
 } texec_thread_pool_executor_config_t;
 
+// Creates the work item and task handle pools of `ex` according to `cfg`; backends call
+// this once `ex->alloc` is set and release the pools when they are destroyed.
+texec_status_t texec_executor_init_pools(texec_executor_t* ex, const texec_executor_pool_config_t* cfg);
+void texec_executor_release_pools(texec_executor_t* ex);
+
+typedef struct texec_inline_executor_config {
+  const texec_allocator_t* alloc;
+  const texec_diagnostics_t* diag;
+  texec_executor_pool_config_t pool; // only task handles are pooled; tasks never become work items
+  texec_deadline_policy_t deadline_policy;
+} texec_inline_executor_config_t;
+
+texec_status_t texec_executor_create_inline(const texec_inline_executor_config_t* cfg, texec_executor_t** out_ex);
 texec_status_t texec_executor_create_thread_pool(const texec_thread_pool_executor_config_t* cfg, texec_executor_t** out_ex);
+texec_status_t texec_executor_create_work_stealing(const texec_thread_pool_executor_config_t* cfg, texec_executor_t** out_ex);
+
+static inline texec_work_item_t* texec_executor_allocate_work_item(const texec_executor_t* ex) {
+  if (ex->work_item_pool) return texec_work_item_acquire(ex->work_item_pool);
+  return texec_work_item_allocate(ex->alloc);
+}
+
+static inline texec_task_group_t* texec_executor_find_submit_group(const texec_submit_info_t* info) {
+  const texec_submit_group_info_t* gi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_GROUP);
+  return gi ? gi->group : NULL;
+}
+
+// The task's own cancel token, or else the one of the group counting it.
+static inline texec_cancel_token_t* texec_executor_find_submit_cancel_token(const texec_submit_info_t* info, const texec_task_group_t* group) {
+  const texec_submit_cancel_info_t* ci = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_CANCEL);
+  if (ci) return ci->token;
+  return group ? texec_task_group_cancel_token(group) : NULL;
+}
+
+static inline const texec_submit_context_info_t* texec_executor_find_submit_context(const texec_submit_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_CONTEXT);
+}
+
+static inline size_t texec_executor_find_submit_payload_size(const texec_submit_info_t* info) {
+  const texec_submit_result_payload_info_t* pi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_RESULT_PAYLOAD);
+  return pi ? pi->size : 0;
+}
+
+// Handles with result storage come straight from the allocator; the pool's are all one size.
+static inline texec_task_handle_t* texec_executor_create_task_handle(const texec_executor_t* ex, size_t payload_size) {
+  if (payload_size) return texec_task_handle_create_with_payload(ex->alloc, payload_size);
+  if (ex->handle_pool) return texec_task_handle_create_pooled(ex->handle_pool);
+  return texec_task_handle_create(ex->alloc);
+}
+
+// Carries the handle a dependent submission created up front (see texec_executor_submit_dependent)
+// to the backend's submit, which hands it out instead of creating one.
+#define TEXEC_STRUCT_TYPE_SUBMIT_INTERNAL_HANDLE ((texec_struct_type_t)0x2F00)
+
+typedef struct texec_submit_internal_handle_info {
+  texec_structure_header_t header;
+  texec_task_handle_t* handle;
+} texec_submit_internal_handle_info_t;
+
+// Keeps a task submitted from a worker out of the worker's LIFO slot, for work meant to be picked
+// up by other workers while the submitting task keeps running.
+#define TEXEC_STRUCT_TYPE_SUBMIT_INTERNAL_SHARED ((texec_struct_type_t)0x2F01)
+
+// Handle returned by a submit that asked for one. Like a fresh handle, it carries one reference.
+static inline texec_task_handle_t* texec_executor_create_submit_handle(const texec_executor_t* ex, const texec_submit_info_t* info) {
+  const texec_submit_internal_handle_info_t* hi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_INTERNAL_HANDLE);
+  if (hi) return texec_task_handle_retain(hi->handle) == TEXEC_STATUS_OK ? hi->handle : NULL;
+  return texec_executor_create_task_handle(ex, texec_executor_find_submit_payload_size(info));
+}
+
+// Registers `info` to be submitted to `ex` once every handle in `deps` is done.
+texec_status_t texec_executor_submit_dependent(texec_executor_t* ex,
+                                               const texec_submit_info_t* info,
+                                               const texec_submit_dependencies_info_t* deps,
+                                               texec_task_handle_t** out_handle);
 
 static inline void texec_task_on_complete(const texec_task_t* t) {
   if (!t->on_complete) return;
   t->on_complete(t->ctx);
 }
 
+// Runs `task` and publishes its result to `h` and `group`, either of which may be NULL.
+static inline int texec_executor_run_task(const texec_executor_t* ex,
+                                          const texec_task_t* task,
+                                          const void* trace_context,
+                                          texec_task_handle_t* h,
+                                          texec_task_group_t* group) {
+  texec_diagnostics_on_task_begin(ex->diag, task, trace_context);
+  // Tasks nest on one thread (caller-runs, helping waits): restore the outer task's handle after
+  texec_task_handle_t* const outer = texec_task_handle_current;
+  texec_task_handle_current = h;
+  const int result = task->run(task->ctx);
+  texec_task_handle_current = outer;
+  texec_diagnostics_on_task_end(ex->diag, task, trace_context, result);
+  texec_task_on_complete(task);
+  if (h) {
+    texec_task_handle_complete(h, result);
+  }
+  if (group) {
+    texec_task_group_record_result(group, result);
+  }
+  return result;
+}
+
+// Completes `task` without running it: `h` reports `reason`, and on_complete still runs so the
+// task can release its context.
+static inline void texec_executor_drop_task(const texec_executor_t* ex,
+                                            const texec_task_t* task,
+                                            const void* trace_context,
+                                            texec_task_handle_t* h,
+                                            texec_status_t reason) {
+  texec_diagnostics_on_task_dropped(ex->diag, task, trace_context, reason);
+  texec_task_on_complete(task);
+  if (h) {
+    texec_task_handle_drop(h, reason);
+  }
+}
+
+// Counted groups are left without a result.
+static inline void texec_executor_drop_work_item(const texec_executor_t* ex, texec_work_item_t* wi, texec_status_t reason) {
+  if (texec_work_item_is_intrusive(wi)) {
+    texec_intrusive_task_t* t = texec_work_item_intrusive(wi);
+    texec_executor_drop_task(ex, &t->task, NULL, NULL, reason);
+    if (t->done) t->done(t, reason, 0);
+    return;
+  }
+  texec_executor_drop_task(ex, &wi->task, wi->trace_context, wi->handle, reason);
+  texec_work_item_destroy(wi, ex->alloc);
+}
+
+// Runs the work item, unless its cancel token was cancelled while it was queued.
 static inline void texec_executor_consume_work_item(const texec_executor_t* ex, texec_work_item_t* wi) {
-  texec_diagnostics_on_task_begin(ex->diag, &wi->task, wi->trace_context);
-  const int result = wi->task.run(wi->task.ctx);
-  texec_diagnostics_on_task_end(ex->diag, &wi->task, wi->trace_context, result);
-  texec_task_on_complete(&wi->task);
-  texec_task_handle_complete(wi->handle, result);
+  if (texec_work_item_is_intrusive(wi)) {
+    texec_intrusive_task_t* t = texec_work_item_intrusive(wi);
+    const int result = texec_executor_run_task(ex, &t->task, NULL, NULL, NULL);
+    if (t->done) t->done(t, TEXEC_STATUS_OK, result);
+    return;
+  }
+  if (wi->cancel && texec_cancel_token_is_cancelled(wi->cancel)) {
+    texec_executor_drop_work_item(ex, wi, TEXEC_STATUS_CANCELLED);
+    return;
+  }
+  texec_executor_run_task(ex, &wi->task, wi->trace_context, wi->handle, wi->group);
   texec_work_item_destroy(wi, ex->alloc);
 }
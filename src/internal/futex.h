@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Address-based wait/wake. Uses futex(2) on Linux and a global parking lot elsewhere.
+// Waits may return spuriously; callers must re-check their condition.
+// Wakes never dereference `addr`, so waking an address whose owner was just freed is harmless.
+
+void texec_futex_wait(atomic_uint* addr, unsigned int expected);
+
+// Returns false if `timeout_ns` elapsed without a wake-up (spurious returns report true).
+bool texec_futex_wait_timeout(atomic_uint* addr, unsigned int expected, uint64_t timeout_ns);
+void texec_futex_wake_one(atomic_uint* addr);
+void texec_futex_wake_many(atomic_uint* addr, unsigned int count);
+void texec_futex_wake_all(atomic_uint* addr);
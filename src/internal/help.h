@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Lets a pool worker that blocks inside a task (on a handle, a group or a parallel loop) run
+// other queued tasks instead of sleeping, so that fork-join code cannot starve or deadlock a
+// small pool. Workers install a helper for their thread; waits call texec_help_run_one between
+// checks of their condition and park through texec_help_park.
+
+typedef struct texec_helper {
+  // Runs one queued task of the worker's executor; returns false if there was none
+  bool (*run_one)(void* worker);
+  void* worker;
+} texec_helper_t;
+
+// Longest a helping waiter parks before it looks for queued tasks again: the tasks it waits for
+// do not wake it when they queue more work.
+#define TEXEC_HELP_PARK_NS 1000000u
+
+// Installs `helper` (NULL to remove it) for the calling thread; it must outlive the installation.
+void texec_help_install(const texec_helper_t* helper);
+
+// Runs one queued task if the calling thread is a worker with one to run and `deadline_ns`
+// (UINT64_MAX: none) has not passed. A task started just before the deadline still runs to
+// completion, so a timed wait may overshoot by the length of one task.
+bool texec_help_run_one(uint64_t deadline_ns);
+
+// Parks on `word` while it holds `expected`, until `deadline_ns` (UINT64_MAX: none) at the
+// latest and, on a thread that can help, for no more than TEXEC_HELP_PARK_NS. Returns false once
+// the deadline has passed.
+bool texec_help_park(atomic_uint* word, unsigned int expected, uint64_t deadline_ns);
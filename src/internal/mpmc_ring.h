@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "texec/base.h"
+
+#include "internal/cache_line.h"
+
+// Bounded lock-free MPMC ring (Vyukov): every slot carries a sequence number that tells
+// producers and consumers whether it is free for the lap they are on.
+// Closing sets a bit in the tail so that no push can be claimed afterwards.
+
+typedef struct texec_mpmc_slot {
+  atomic_size_t seq;
+  atomic_uintptr_t item;
+} texec_mpmc_slot_t;
+
+typedef struct texec_mpmc_ring {
+  TEXEC_CACHE_ALIGNED atomic_size_t head;
+  TEXEC_CACHE_ALIGNED atomic_size_t tail;
+  TEXEC_CACHE_ALIGNED texec_mpmc_slot_t* slots;
+  size_t mask;
+} texec_mpmc_ring_t;
+
+// Capacity is rounded up to a power of two.
+texec_status_t texec_mpmc_ring_init(texec_mpmc_ring_t* r, size_t min_capacity, const texec_allocator_t* alloc);
+void texec_mpmc_ring_destroy(texec_mpmc_ring_t* r, const texec_allocator_t* alloc);
+
+// Returns OK, REJECTED (full) or CLOSED.
+texec_status_t texec_mpmc_ring_try_push(texec_mpmc_ring_t* r, uintptr_t item);
+
+// Returns OK, REJECTED (empty) or CLOSED (closed and drained).
+texec_status_t texec_mpmc_ring_try_pop(texec_mpmc_ring_t* r, uintptr_t* out_item);
+
+// Claims as many contiguous slots as are free (up to `count`) with a single CAS.
+// Returns OK with *out_pushed >= 1, REJECTED (full) or CLOSED.
+texec_status_t texec_mpmc_ring_try_push_many(texec_mpmc_ring_t* r, const uintptr_t* items, size_t count, size_t* out_pushed);
+
+// Claims as many contiguous published items as are available (up to `max_count`) with a single CAS.
+// Returns OK with *out_popped >= 1, REJECTED (empty) or CLOSED (closed and drained).
+texec_status_t texec_mpmc_ring_try_pop_many(texec_mpmc_ring_t* r, uintptr_t* out_items, size_t max_count, size_t* out_popped);
+
+void texec_mpmc_ring_close(texec_mpmc_ring_t* r);
+bool texec_mpmc_ring_is_closed(const texec_mpmc_ring_t* r);
+
+// Claimed slots, including pushes and pops still in progress; only a snapshot.
+size_t texec_mpmc_ring_size(const texec_mpmc_ring_t* r);
+
+static inline size_t texec_mpmc_ring_capacity(const texec_mpmc_ring_t* r) {
+  return r->mask + 1;
+}
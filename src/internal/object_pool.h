@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "texec/base.h"
+
+// Fixed-size object pool with per-thread caches.
+//
+// Objects are carved from slabs drawn from the pool's allocator and are initialized once
+// (init) when their slab is created and finalized (fini) when the pool goes away, so
+// expensive per-object setup is not repeated on every acquire.
+//
+// Each thread keeps a small cache of free objects per pool, refilled from and flushed to a
+// shared free list in batches. The pool outlives its owner's release for as long as objects
+// are in use or parked in some thread's cache.
+
+typedef struct texec_object_pool texec_object_pool_t;
+
+typedef bool (*texec_object_pool_init_fn_t)(void* obj);
+typedef void (*texec_object_pool_fini_fn_t)(void* obj);
+
+typedef struct texec_object_pool_config {
+  const texec_allocator_t* alloc;
+  size_t object_size;
+  size_t object_align;
+  size_t slab_capacity;         // objects per slab
+  size_t thread_cache_capacity; // 0 disables per-thread caching
+  texec_object_pool_init_fn_t init; // optional
+  texec_object_pool_fini_fn_t fini; // optional
+} texec_object_pool_config_t;
+
+texec_status_t texec_object_pool_create(const texec_object_pool_config_t* cfg, texec_object_pool_t** out_pool);
+
+// Drops the owner's reference; memory is returned once every object has come back.
+void texec_object_pool_release(texec_object_pool_t* pool);
+
+// Allocator the pool's slabs are drawn from.
+const texec_allocator_t* texec_object_pool_allocator(const texec_object_pool_t* pool);
+
+void* texec_object_pool_acquire(texec_object_pool_t* pool);
+void texec_object_pool_recycle(texec_object_pool_t* pool, void* obj);
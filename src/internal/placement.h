@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "texec/executor_create_info.h"
+
+// Where a pool's workers run and which NUMA node's queues they serve, derived from a
+// texec_executor_create_affinity_info_t. The usable CPUs are grouped by NUMA node, and worker i
+// belongs to group i % group_count so that workers are spread evenly over the nodes.
+
+typedef struct texec_placement {
+  unsigned int* cpus;          // usable CPUs, grouped
+  size_t cpu_count;
+  size_t* group_first;         // group_count + 1 offsets into cpus
+  unsigned int* group_nodes;   // OS node number of each group
+  size_t group_count;          // 0: no placement, workers are not pinned and there is one group
+  size_t* cpu_groups;          // group of each CPU number below cpu_groups_length, SIZE_MAX if unused
+  size_t cpu_groups_length;
+  unsigned int* creator_cpus;  // affinity of the creating thread, restored after node-local allocation
+  size_t creator_cpu_count;
+  texec_worker_pinning_t pinning;
+  bool restrict_workers;       // CPUs were listed explicitly: unpinned workers still stay on them
+  const texec_allocator_t* alloc;
+} texec_placement_t;
+
+// Number of CPUs the pool may use, capped by the cgroup CPU quota; 0 if unknown.
+size_t texec_placement_usable_cpu_count(const texec_executor_create_affinity_info_t* info);
+
+// `info` may be NULL, which yields an empty placement.
+texec_status_t texec_placement_init(texec_placement_t* p, const texec_executor_create_affinity_info_t* info, const texec_allocator_t* alloc);
+void texec_placement_destroy(texec_placement_t* p);
+
+static inline size_t texec_placement_group_count(const texec_placement_t* p) {
+  return p->group_count ? p->group_count : 1;
+}
+
+static inline size_t texec_placement_worker_group(const texec_placement_t* p, size_t worker_index) {
+  return worker_index % texec_placement_group_count(p);
+}
+
+// CPUs worker `worker_index` is restricted to; `*out_count` is 0 if it is not restricted.
+void texec_placement_worker_cpus(const texec_placement_t* p, size_t worker_index, const unsigned int** out_cpus, size_t* out_count);
+
+// Group of the CPU the calling thread runs on; 0 if unknown.
+size_t texec_placement_current_group(const texec_placement_t* p);
+
+// Group serving OS node `node`. Returns false if the pool has no CPUs on that node.
+bool texec_placement_find_node(const texec_placement_t* p, unsigned int node, size_t* out_group);
+
+// Moves the calling thread onto the CPUs of `group` so that memory it touches first is
+// allocated on that node, until texec_placement_leave_group restores its affinity.
+void texec_placement_enter_group(const texec_placement_t* p, size_t group);
+void texec_placement_leave_group(const texec_placement_t* p);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "texec/base.h"
+#include "texec/cancel_token.h"
+#include "texec/task_group.h"
+
+// Adds `count` tasks to the group's pending counter. Fails with TEXEC_STATUS_REJECTED if the
+// counter would overflow.
+texec_status_t texec_task_group_enter(texec_task_group_t* g, size_t count);
+
+// Removes `count` tasks from the pending counter, waking waiters (or freeing a destroyed group)
+// when it drains. `g` must not be touched by the caller afterwards.
+void texec_task_group_leave(texec_task_group_t* g, size_t count);
+
+// Token attached to the group's counted tasks, or NULL.
+texec_cancel_token_t* texec_task_group_cancel_token(const texec_task_group_t* g);
+
+// Folds a counted task's result into the group's aggregate; call before texec_task_group_leave.
+void texec_task_group_record_result(texec_task_group_t* g, int result);
@@ -1,8 +1,50 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "texec/base.h"
 #include "texec/task_handle.h"
 
+#include "internal/object_pool.h"
+
 texec_task_handle_t* texec_task_handle_create(const texec_allocator_t* alloc);
+
+// Handle followed by `payload_size` zeroed bytes of result storage; plain handle for 0.
+texec_task_handle_t* texec_task_handle_create_with_payload(const texec_allocator_t* alloc, size_t payload_size);
+
+texec_status_t texec_task_handle_pool_create(const texec_allocator_t* alloc,
+                                             size_t slab_capacity,
+                                             size_t thread_cache_capacity,
+                                             texec_object_pool_t** out_pool);
+texec_task_handle_t* texec_task_handle_create_pooled(texec_object_pool_t* pool);
+
 void texec_task_handle_destroy(texec_task_handle_t* h);
+
+// Handle of the task running on the calling thread, if it has one: texec_task_result_payload
+// reads it. Set by texec_executor_run_task.
+extern _Thread_local texec_task_handle_t* texec_task_handle_current;
 void texec_task_handle_complete(texec_task_handle_t* h, int result);
+
+// Completes the handle without a result; texec_task_handle_result then returns `reason`.
+void texec_task_handle_drop(texec_task_handle_t* h, texec_status_t reason);
+
+// Runs once the handle is completed or dropped, on the thread that does so, after the result is
+// published. Nodes are owned by whoever adds them and must stay valid until `fire` is called or
+// they are removed.
+typedef struct texec_task_handle_continuation {
+  struct texec_task_handle_continuation* prev;
+  struct texec_task_handle_continuation* next;
+  void (*fire)(struct texec_task_handle_continuation* c);
+} texec_task_handle_continuation_t;
+
+// Returns false without adding `c` if the handle is already done; the caller then proceeds as
+// if `c` had fired.
+bool texec_task_handle_add_continuation(texec_task_handle_t* h, texec_task_handle_continuation_t* c);
+
+// Takes back a continuation added to `h`. Returns false if the handle completed first: `c` is
+// then fired (or being fired) by the completer and stays valid until it is.
+bool texec_task_handle_remove_continuation(texec_task_handle_t* h, texec_task_handle_continuation_t* c);
+
+// Allocator of the handle's owner: the one it, or its pool, was allocated from.
+const texec_allocator_t* texec_task_handle_allocator(const texec_task_handle_t* h);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "texec/executor.h"
+
+// Timers of an executor live in a timer service: a timing wheel and the thread that turns due
+// timers into submits. The first texec_executor_schedule starts it; executors only keep the
+// pointer, set to a sentinel when they are closed before any timer was scheduled.
+
+typedef struct texec_timer_service texec_timer_service_t;
+
+// Refuses new timers and makes the timer thread drop pending ones with TEXEC_STATUS_CLOSED.
+void texec_executor_close_timers(texec_executor_t* ex);
+
+// Closes the timers and waits for the timer thread to exit.
+void texec_executor_join_timers(texec_executor_t* ex);
+
+// Backends call this when they are destroyed; timers the caller still holds stay valid.
+void texec_executor_release_timers(texec_executor_t* ex);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hierarchical timing wheel over an abstract tick count: TEXEC_TIMER_WHEEL_LEVELS levels of 64
+// slots, level L slot covering 64^L ticks. Entries are intrusive and doubly linked, so insertion
+// and removal are O(1); advancing costs one step per occupied slot passed, plus cascading entries
+// of higher levels down as their slot comes due. Not synchronized: callers hold their own lock.
+
+#define TEXEC_TIMER_WHEEL_LEVELS 6
+#define TEXEC_TIMER_WHEEL_SLOTS  64
+
+typedef struct texec_timer_wheel_entry {
+  struct texec_timer_wheel_entry* prev;
+  struct texec_timer_wheel_entry* next; // also links the due list returned by advance
+  uint64_t when;                        // tick the entry is due at
+  unsigned int level;
+  unsigned int slot;
+} texec_timer_wheel_entry_t;
+
+typedef struct texec_timer_wheel {
+  uint64_t elapsed; // every tick up to this one has been processed
+  uint64_t occupied[TEXEC_TIMER_WHEEL_LEVELS]; // bit s set when slot s has entries
+  texec_timer_wheel_entry_t* slots[TEXEC_TIMER_WHEEL_LEVELS][TEXEC_TIMER_WHEEL_SLOTS];
+  size_t count;
+} texec_timer_wheel_t;
+
+void texec_timer_wheel_init(texec_timer_wheel_t* w);
+
+// Links `e`, which must have `when` > w->elapsed.
+void texec_timer_wheel_insert(texec_timer_wheel_t* w, texec_timer_wheel_entry_t* e);
+void texec_timer_wheel_remove(texec_timer_wheel_t* w, texec_timer_wheel_entry_t* e);
+
+// Earliest tick at which advance has work to do; UINT64_MAX when the wheel is empty.
+uint64_t texec_timer_wheel_next_expiration(const texec_timer_wheel_t* w);
+
+// Processes every tick up to `now` and returns the entries due by then, unlinked and chained
+// through `next`.
+texec_timer_wheel_entry_t* texec_timer_wheel_advance(texec_timer_wheel_t* w, uint64_t now);
+
+// Unlinks every entry and returns them chained through `next`.
+texec_timer_wheel_entry_t* texec_timer_wheel_take_all(texec_timer_wheel_t* w);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// CPU and NUMA queries and thread pinning. Implemented on Linux (sched affinity, sysfs and the
+// cgroup CPU controller) and Windows (processor group 0); elsewhere every query reports nothing
+// and pinning fails, so callers fall back to unplaced workers.
+
+#define TEXEC_TOPOLOGY_MAX_CPUS 1024
+
+// Writes the CPUs the calling thread may run on, in ascending order, and returns their number.
+size_t texec_topology_available_cpus(unsigned int* out_cpus, size_t capacity);
+
+// Number of CPUs the cgroup CPU quota allows (rounded up), or 0 if there is no quota.
+size_t texec_topology_cpu_quota(void);
+
+// NUMA node `cpu` belongs to; 0 if unknown.
+unsigned int texec_topology_cpu_node(unsigned int cpu);
+
+// CPU the calling thread is running on. Returns false if unknown.
+bool texec_topology_current_cpu(unsigned int* out_cpu);
+
+// Restricts the calling thread to `cpus`. Returns false if unsupported or refused.
+bool texec_topology_pin_current_thread(const unsigned int* cpus, size_t count);
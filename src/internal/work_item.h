@@ -1,22 +1,101 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "texec/base.h"
+#include "texec/cancel_token.h"
+#include "texec/executor_submit_info.h"
 #include "texec/task.h"
 #include "texec/task_handle.h"
 
 #include "internal/allocator.h"
+#include "internal/context_copy.h"
+#include "internal/object_pool.h"
+#include "internal/task_group.h"
 
 typedef struct texec_work_item {
   texec_task_t task;
-  texec_task_handle_t* handle;
+  texec_task_handle_t* handle; // NULL for detached submissions
+  texec_task_group_t* group;   // counted group, if any
   const void* trace_context;
+  texec_cancel_token_t* cancel; // retained; NULL if the task cannot be cancelled
+  texec_object_pool_t* pool; // NULL when allocated directly from the executor's allocator
+  texec_context_copy_t context; // task.ctx points into it when submitted with a context blob
 } texec_work_item_t;
 
+// Queues carry work items and, tagged with TEXEC_WORK_ITEM_INTRUSIVE, caller-owned intrusive
+// tasks. Only the functions below and in internal/executor.h look behind the pointer.
+#define TEXEC_WORK_ITEM_INTRUSIVE ((uintptr_t)1)
+
+static inline bool texec_work_item_is_intrusive(const texec_work_item_t* wi) {
+  return ((uintptr_t)wi & TEXEC_WORK_ITEM_INTRUSIVE) != 0;
+}
+
+static inline texec_work_item_t* texec_work_item_from_intrusive(texec_intrusive_task_t* t) {
+  return (texec_work_item_t*)((uintptr_t)t | TEXEC_WORK_ITEM_INTRUSIVE);
+}
+
+static inline texec_intrusive_task_t* texec_work_item_intrusive(texec_work_item_t* wi) {
+  return (texec_intrusive_task_t*)((uintptr_t)wi & ~TEXEC_WORK_ITEM_INTRUSIVE);
+}
+
+static inline texec_status_t texec_work_item_pool_create(const texec_allocator_t* alloc,
+                                                         size_t slab_capacity,
+                                                         size_t thread_cache_capacity,
+                                                         texec_object_pool_t** out_pool) {
+  const texec_object_pool_config_t cfg = {
+    .alloc = alloc,
+    .object_size = sizeof(texec_work_item_t),
+    .object_align = _Alignof(texec_work_item_t),
+    .slab_capacity = slab_capacity,
+    .thread_cache_capacity = thread_cache_capacity,
+  };
+  return texec_object_pool_create(&cfg, out_pool);
+}
+
 static inline texec_work_item_t* texec_work_item_allocate(const texec_allocator_t* alloc) {
-  return texec_allocate(alloc, sizeof(texec_work_item_t), _Alignof(texec_work_item_t));
+  texec_work_item_t* wi = texec_allocate(alloc, sizeof(texec_work_item_t), _Alignof(texec_work_item_t));
+  if (wi) {
+    wi->pool = NULL;
+    wi->context.heap = NULL;
+  }
+  return wi;
+}
+
+static inline texec_work_item_t* texec_work_item_acquire(texec_object_pool_t* pool) {
+  texec_work_item_t* wi = texec_object_pool_acquire(pool);
+  if (wi) {
+    wi->pool = pool;
+    wi->context.heap = NULL;
+  }
+  return wi;
+}
+
+// Attaches `token` (may be NULL) to `wi`, which holds a reference until it is destroyed.
+static inline void texec_work_item_set_cancel_token(texec_work_item_t* wi, texec_cancel_token_t* token) {
+  wi->cancel = token && texec_cancel_token_retain(token) == TEXEC_STATUS_OK ? token : NULL;
+}
+
+// Points wi->task.ctx at a copy of the blob of `info`, which the work item owns from then on.
+static inline bool texec_work_item_copy_context(texec_work_item_t* wi, const texec_allocator_t* alloc, const texec_submit_context_info_t* info) {
+  return texec_context_copy_init(&wi->context, alloc, info, &wi->task.ctx);
 }
 
+// Intrusive tasks are the caller's: one that was never run is simply left alone.
 static inline void texec_work_item_destroy(texec_work_item_t* wi, const texec_allocator_t* alloc) {
-  texec_task_handle_release(wi->handle);
+  if (texec_work_item_is_intrusive(wi)) return;
+  if (wi->handle) {
+    texec_task_handle_release(wi->handle);
+  }
+  if (wi->group) {
+    texec_task_group_leave(wi->group, 1);
+  }
+  texec_cancel_token_release(wi->cancel);
+  texec_context_copy_release(&wi->context, alloc);
+  if (wi->pool) {
+    texec_object_pool_recycle(wi->pool, wi);
+    return;
+  }
   texec_free(alloc, wi, sizeof(*wi), _Alignof(texec_work_item_t));
 }
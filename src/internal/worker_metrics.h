@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "texec/clock.h"
+#include "texec/executor.h"
+
+#include "internal/cache_line.h"
+
+// Counters owned by a single worker, padded to their own cache line(s). Only the owner writes
+// them, using a relaxed load and store instead of a read-modify-write, so updates cost the same
+// as plain increments while texec_executor_query can still read them from any thread.
+typedef struct texec_worker_counters {
+  TEXEC_CACHE_ALIGNED atomic_uint_least64_t tasks_executed;
+  atomic_uint_least64_t steals;
+  atomic_uint_least64_t parks;
+  atomic_uint_least64_t busy_ns;
+  atomic_uint_least64_t idle_ns;
+  atomic_uint_least64_t since_ns; // start of the current busy or idle stretch
+  atomic_bool parked;
+} texec_worker_counters_t;
+
+static inline void texec_worker_counters_init(texec_worker_counters_t* c) {
+  atomic_init(&c->tasks_executed, 0);
+  atomic_init(&c->steals, 0);
+  atomic_init(&c->parks, 0);
+  atomic_init(&c->busy_ns, 0);
+  atomic_init(&c->idle_ns, 0);
+  atomic_init(&c->since_ns, texec_clock_now_ns());
+  atomic_init(&c->parked, false);
+}
+
+// Owner only.
+static inline void texec_worker_counter_add(atomic_uint_least64_t* counter, uint64_t n) {
+  atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+// Owner only: closes the current busy or idle stretch and starts the other one.
+static inline void texec_worker_counters_transition(texec_worker_counters_t* c, bool parked) {
+  const uint64_t now = texec_clock_now_ns();
+  const uint64_t elapsed = now - atomic_load_explicit(&c->since_ns, memory_order_relaxed);
+  texec_worker_counter_add(parked ? &c->busy_ns : &c->idle_ns, elapsed);
+  atomic_store_explicit(&c->since_ns, now, memory_order_relaxed);
+  atomic_store_explicit(&c->parked, parked, memory_order_relaxed);
+  if (parked) {
+    texec_worker_counter_add(&c->parks, 1);
+  }
+}
+
+// Any thread. The stretch in progress is credited to busy or idle time up to `now_ns`.
+static inline void texec_worker_counters_snapshot(const texec_worker_counters_t* c, uint64_t now_ns, texec_worker_metrics_t* out) {
+  out->tasks_executed = atomic_load_explicit(&c->tasks_executed, memory_order_relaxed);
+  out->steals = atomic_load_explicit(&c->steals, memory_order_relaxed);
+  out->parks = atomic_load_explicit(&c->parks, memory_order_relaxed);
+  out->busy_ns = atomic_load_explicit(&c->busy_ns, memory_order_relaxed);
+  out->idle_ns = atomic_load_explicit(&c->idle_ns, memory_order_relaxed);
+  out->queue_depth = 0;
+
+  const uint64_t since = atomic_load_explicit(&c->since_ns, memory_order_relaxed);
+  const uint64_t current = now_ns > since ? now_ns - since : 0;
+  if (atomic_load_explicit(&c->parked, memory_order_relaxed)) {
+    out->idle_ns += current;
+  } else {
+    out->busy_ns += current;
+  }
+}
+
+// Adds a worker snapshot into the executor-wide totals.
+static inline void texec_executor_metrics_accumulate(texec_executor_metrics_t* total, const texec_worker_metrics_t* w) {
+  total->tasks_executed += w->tasks_executed;
+  total->steals += w->steals;
+  total->parks += w->parks;
+  total->busy_ns += w->busy_ns;
+  total->idle_ns += w->idle_ns;
+  total->queue_depth += w->queue_depth;
+}
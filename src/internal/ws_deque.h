@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "texec/base.h"
+
+#include "internal/cache_line.h"
+
+// Bounded Chase-Lev work-stealing deque.
+// The owner pushes and pops at the bottom; any thread may steal from the top.
+
+typedef struct texec_ws_deque {
+  TEXEC_CACHE_ALIGNED atomic_ptrdiff_t top;
+  TEXEC_CACHE_ALIGNED atomic_ptrdiff_t bottom;
+  TEXEC_CACHE_ALIGNED atomic_uintptr_t* buf;
+  size_t mask;
+  const texec_allocator_t* alloc;
+} texec_ws_deque_t;
+
+texec_status_t texec_ws_deque_init(texec_ws_deque_t* d, size_t min_capacity, const texec_allocator_t* alloc);
+void texec_ws_deque_destroy(texec_ws_deque_t* d);
+
+// Owner only. Returns false when the deque is full.
+bool texec_ws_deque_push(texec_ws_deque_t* d, uintptr_t item);
+
+// Owner only. Returns false when the deque is empty.
+bool texec_ws_deque_pop(texec_ws_deque_t* d, uintptr_t* out_item);
+
+// Any thread. Returns false when the deque is empty or the race for the top item was lost.
+bool texec_ws_deque_steal(texec_ws_deque_t* d, uintptr_t* out_item);
+
+// Any thread; a snapshot.
+static inline size_t texec_ws_deque_size(texec_ws_deque_t* d) {
+  const ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  const ptrdiff_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+  return b > t ? (size_t)(b - t) : 0;
+}
+
+static inline bool texec_ws_deque_is_empty(texec_ws_deque_t* d) {
+  const ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  const ptrdiff_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+  return b <= t;
+}
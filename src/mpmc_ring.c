@@ -0,0 +1,201 @@
+#include "internal/mpmc_ring.h"
+
+#include <limits.h>
+#include <stdbool.h>
+
+#include "internal/allocator.h"
+
+#define MPMC_RING_CLOSED_BIT ((size_t)1 << (sizeof(size_t) * CHAR_BIT - 1))
+
+static inline size_t round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+static inline size_t mpmc_ring_slots_size(size_t capacity) {
+  return capacity * sizeof(texec_mpmc_slot_t);
+}
+
+texec_status_t texec_mpmc_ring_init(texec_mpmc_ring_t* r, size_t min_capacity, const texec_allocator_t* alloc) {
+  const size_t capacity = round_up_pow2(min_capacity);
+  if (capacity >= MPMC_RING_CLOSED_BIT) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  texec_mpmc_slot_t* slots = texec_allocate(alloc, mpmc_ring_slots_size(capacity), TEXEC_CACHE_LINE_SIZE);
+  if (!slots) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  for (size_t i = 0; i < capacity; ++i) {
+    atomic_init(&slots[i].seq, i);
+    atomic_init(&slots[i].item, 0);
+  }
+
+  atomic_init(&r->head, 0);
+  atomic_init(&r->tail, 0);
+  r->slots = slots;
+  r->mask = capacity - 1;
+  return TEXEC_STATUS_OK;
+}
+
+void texec_mpmc_ring_destroy(texec_mpmc_ring_t* r, const texec_allocator_t* alloc) {
+  if (!r->slots) return;
+  texec_free(alloc, r->slots, mpmc_ring_slots_size(r->mask + 1), TEXEC_CACHE_LINE_SIZE);
+  r->slots = NULL;
+}
+
+static inline bool mpmc_ring_closed_and_drained(texec_mpmc_ring_t* r, size_t head) {
+  const size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+  return (tail & MPMC_RING_CLOSED_BIT) && (tail & ~MPMC_RING_CLOSED_BIT) == head;
+}
+
+texec_status_t texec_mpmc_ring_try_push(texec_mpmc_ring_t* r, uintptr_t item) {
+  size_t pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+  texec_mpmc_slot_t* slot = NULL;
+
+  for (;;) {
+    if (pos & MPMC_RING_CLOSED_BIT) return TEXEC_STATUS_CLOSED;
+
+    slot = &r->slots[pos & r->mask];
+    const size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    const ptrdiff_t dif = (ptrdiff_t)(seq - pos);
+
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (dif < 0) {
+      // The slot still holds an item from the previous lap
+      return TEXEC_STATUS_REJECTED;
+    } else {
+      pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    }
+  }
+
+  atomic_store_explicit(&slot->item, item, memory_order_relaxed);
+  atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_mpmc_ring_try_pop(texec_mpmc_ring_t* r, uintptr_t* out_item) {
+  size_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+  texec_mpmc_slot_t* slot = NULL;
+
+  for (;;) {
+    slot = &r->slots[pos & r->mask];
+    const size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    const ptrdiff_t dif = (ptrdiff_t)(seq - (pos + 1));
+
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&r->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (dif < 0) {
+      // Empty, or a claimed push has not been published yet
+      return mpmc_ring_closed_and_drained(r, pos) ? TEXEC_STATUS_CLOSED : TEXEC_STATUS_REJECTED;
+    } else {
+      pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    }
+  }
+
+  *out_item = atomic_load_explicit(&slot->item, memory_order_relaxed);
+  atomic_store_explicit(&slot->seq, pos + r->mask + 1, memory_order_release);
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_mpmc_ring_try_push_many(texec_mpmc_ring_t* r, const uintptr_t* items, size_t count, size_t* out_pushed) {
+  *out_pushed = 0;
+  if (count == 0) return TEXEC_STATUS_OK;
+
+  size_t pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+  size_t n = 0;
+
+  for (;;) {
+    if (pos & MPMC_RING_CLOSED_BIT) return TEXEC_STATUS_CLOSED;
+
+    n = 0;
+    ptrdiff_t first_dif = 0;
+    while (n < count) {
+      const size_t seq = atomic_load_explicit(&r->slots[(pos + n) & r->mask].seq, memory_order_acquire);
+      const ptrdiff_t dif = (ptrdiff_t)(seq - (pos + n));
+      if (n == 0) first_dif = dif;
+      if (dif != 0) break;
+      ++n;
+    }
+
+    if (n == 0) {
+      if (first_dif < 0) return TEXEC_STATUS_REJECTED;
+      pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+      continue;
+    }
+
+    if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + n, memory_order_relaxed, memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    texec_mpmc_slot_t* slot = &r->slots[(pos + i) & r->mask];
+    atomic_store_explicit(&slot->item, items[i], memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, pos + i + 1, memory_order_release);
+  }
+
+  *out_pushed = n;
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_mpmc_ring_try_pop_many(texec_mpmc_ring_t* r, uintptr_t* out_items, size_t max_count, size_t* out_popped) {
+  *out_popped = 0;
+  if (max_count == 0) return TEXEC_STATUS_OK;
+
+  size_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+  size_t n = 0;
+
+  for (;;) {
+    n = 0;
+    ptrdiff_t first_dif = 0;
+    while (n < max_count) {
+      const size_t seq = atomic_load_explicit(&r->slots[(pos + n) & r->mask].seq, memory_order_acquire);
+      const ptrdiff_t dif = (ptrdiff_t)(seq - (pos + n + 1));
+      if (n == 0) first_dif = dif;
+      if (dif != 0) break;
+      ++n;
+    }
+
+    if (n == 0) {
+      if (first_dif < 0) {
+        return mpmc_ring_closed_and_drained(r, pos) ? TEXEC_STATUS_CLOSED : TEXEC_STATUS_REJECTED;
+      }
+      pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+      continue;
+    }
+
+    if (atomic_compare_exchange_weak_explicit(&r->head, &pos, pos + n, memory_order_relaxed, memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    texec_mpmc_slot_t* slot = &r->slots[(pos + i) & r->mask];
+    out_items[i] = atomic_load_explicit(&slot->item, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, pos + i + r->mask + 1, memory_order_release);
+  }
+
+  *out_popped = n;
+  return TEXEC_STATUS_OK;
+}
+
+void texec_mpmc_ring_close(texec_mpmc_ring_t* r) {
+  atomic_fetch_or_explicit(&r->tail, MPMC_RING_CLOSED_BIT, memory_order_seq_cst);
+}
+
+size_t texec_mpmc_ring_size(const texec_mpmc_ring_t* r) {
+  texec_mpmc_ring_t* mr = (texec_mpmc_ring_t*)r;
+  const size_t head = atomic_load_explicit(&mr->head, memory_order_acquire);
+  const size_t tail = atomic_load_explicit(&mr->tail, memory_order_acquire) & ~MPMC_RING_CLOSED_BIT;
+  if (tail <= head) return 0;
+  const size_t size = tail - head;
+  return size < texec_mpmc_ring_capacity(r) ? size : texec_mpmc_ring_capacity(r);
+}
+
+bool texec_mpmc_ring_is_closed(const texec_mpmc_ring_t* r) {
+  return (atomic_load_explicit(&((texec_mpmc_ring_t*)r)->tail, memory_order_acquire) & MPMC_RING_CLOSED_BIT) != 0;
+}
@@ -0,0 +1,311 @@
+#include "internal/object_pool.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <threads.h>
+
+#include "internal/allocator.h"
+
+// Number of distinct pools a thread caches objects for at the same time
+#define OBJECT_POOL_THREAD_CACHES 4
+
+typedef struct object_pool_slot {
+  struct object_pool_slot* next;
+} object_pool_slot_t;
+
+typedef struct object_pool_slab {
+  struct object_pool_slab* next;
+} object_pool_slab_t;
+
+struct texec_object_pool {
+  mtx_t mtx;
+  const texec_allocator_t* alloc;
+  texec_object_pool_init_fn_t init;
+  texec_object_pool_fini_fn_t fini;
+  size_t object_offset; // from the start of a slot
+  size_t slot_stride;
+  size_t slab_capacity;
+  size_t slab_align;
+  size_t slab_header_size;
+  size_t thread_cache_capacity;
+  object_pool_slot_t* free_list;
+  object_pool_slab_t* slabs;
+  size_t outstanding; // objects in use or parked in thread caches
+  atomic_bool released;
+};
+
+typedef struct object_pool_cache {
+  texec_object_pool_t* pool; // only dereferenced while count != 0
+  object_pool_slot_t* head;
+  size_t count;
+} object_pool_cache_t;
+
+typedef struct object_pool_thread_caches {
+  object_pool_cache_t entries[OBJECT_POOL_THREAD_CACHES];
+  size_t next_victim;
+  bool registered;
+} object_pool_thread_caches_t;
+
+static _Thread_local object_pool_thread_caches_t thread_caches;
+static tss_t thread_caches_key;
+static once_flag thread_caches_once = ONCE_FLAG_INIT;
+
+static inline size_t round_up(size_t n, size_t align) {
+  return (n + align - 1) / align * align;
+}
+
+static inline size_t max_size(size_t a, size_t b) {
+  return a > b ? a : b;
+}
+
+static inline void* object_from_slot(const texec_object_pool_t* pool, object_pool_slot_t* slot) {
+  return (char*)slot + pool->object_offset;
+}
+
+static inline object_pool_slot_t* slot_from_object(const texec_object_pool_t* pool, void* obj) {
+  return (object_pool_slot_t*)((char*)obj - pool->object_offset);
+}
+
+static inline object_pool_slot_t* slab_slot(const texec_object_pool_t* pool, object_pool_slab_t* slab, size_t i) {
+  return (object_pool_slot_t*)((char*)slab + pool->slab_header_size + i * pool->slot_stride);
+}
+
+static inline size_t slab_size(const texec_object_pool_t* pool) {
+  return pool->slab_header_size + pool->slab_capacity * pool->slot_stride;
+}
+
+static void slab_fini_objects(texec_object_pool_t* pool, object_pool_slab_t* slab, size_t count) {
+  if (!pool->fini) return;
+  for (size_t i = 0; i < count; ++i) {
+    pool->fini(object_from_slot(pool, slab_slot(pool, slab, i)));
+  }
+}
+
+// Called with the pool mutex held. Links a new slab's slots into the free list.
+static bool pool_grow_locked(texec_object_pool_t* pool) {
+  object_pool_slab_t* slab = texec_allocate(pool->alloc, slab_size(pool), pool->slab_align);
+  if (!slab) return false;
+
+  if (pool->init) {
+    for (size_t i = 0; i < pool->slab_capacity; ++i) {
+      if (!pool->init(object_from_slot(pool, slab_slot(pool, slab, i)))) {
+        slab_fini_objects(pool, slab, i);
+        texec_free(pool->alloc, slab, slab_size(pool), pool->slab_align);
+        return false;
+      }
+    }
+  }
+
+  for (size_t i = pool->slab_capacity; i-- > 0;) {
+    object_pool_slot_t* slot = slab_slot(pool, slab, i);
+    slot->next = pool->free_list;
+    pool->free_list = slot;
+  }
+
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+  return true;
+}
+
+static void pool_destroy(texec_object_pool_t* pool) {
+  object_pool_slab_t* slab = pool->slabs;
+  while (slab) {
+    object_pool_slab_t* next = slab->next;
+    slab_fini_objects(pool, slab, pool->slab_capacity);
+    texec_free(pool->alloc, slab, slab_size(pool), pool->slab_align);
+    slab = next;
+  }
+
+  mtx_destroy(&pool->mtx);
+  texec_free(pool->alloc, pool, sizeof(*pool), _Alignof(texec_object_pool_t));
+}
+
+// Moves up to `max_count` free slots to `out_head`; returns how many were moved.
+static size_t pool_take(texec_object_pool_t* pool, object_pool_slot_t** out_head, size_t max_count) {
+  mtx_lock(&pool->mtx);
+
+  if (!pool->free_list) {
+    pool_grow_locked(pool);
+  }
+
+  size_t n = 0;
+  object_pool_slot_t* head = NULL;
+  while (n < max_count && pool->free_list) {
+    object_pool_slot_t* slot = pool->free_list;
+    pool->free_list = slot->next;
+    slot->next = head;
+    head = slot;
+    ++n;
+  }
+  pool->outstanding += n;
+
+  mtx_unlock(&pool->mtx);
+
+  *out_head = head;
+  return n;
+}
+
+// Returns a list of `count` slots ending in `tail` to the shared free list.
+static void pool_give_back(texec_object_pool_t* pool, object_pool_slot_t* head, object_pool_slot_t* tail, size_t count) {
+  mtx_lock(&pool->mtx);
+  tail->next = pool->free_list;
+  pool->free_list = head;
+  pool->outstanding -= count;
+  const bool destroy = atomic_load_explicit(&pool->released, memory_order_relaxed) && pool->outstanding == 0;
+  mtx_unlock(&pool->mtx);
+
+  if (destroy) {
+    pool_destroy(pool);
+  }
+}
+
+static void cache_flush(object_pool_cache_t* c, size_t count) {
+  if (count == 0) return;
+
+  object_pool_slot_t* head = c->head;
+  object_pool_slot_t* tail = head;
+  for (size_t i = 1; i < count; ++i) {
+    tail = tail->next;
+  }
+
+  c->head = tail->next;
+  c->count -= count;
+  pool_give_back(c->pool, head, tail, count);
+}
+
+static void thread_caches_destructor(void* arg) {
+  object_pool_thread_caches_t* tc = (object_pool_thread_caches_t*)arg;
+  for (size_t i = 0; i < OBJECT_POOL_THREAD_CACHES; ++i) {
+    cache_flush(&tc->entries[i], tc->entries[i].count);
+    tc->entries[i].pool = NULL;
+  }
+}
+
+static void thread_caches_key_init(void) {
+  tss_create(&thread_caches_key, &thread_caches_destructor);
+}
+
+static object_pool_cache_t* thread_cache_for(texec_object_pool_t* pool) {
+  object_pool_thread_caches_t* tc = &thread_caches;
+
+  object_pool_cache_t* empty = NULL;
+  for (size_t i = 0; i < OBJECT_POOL_THREAD_CACHES; ++i) {
+    object_pool_cache_t* c = &tc->entries[i];
+    if (c->pool == pool) return c;
+    if (!empty && c->count == 0) empty = c;
+  }
+
+  if (!tc->registered) {
+    // Flush this thread's caches when it exits
+    call_once(&thread_caches_once, &thread_caches_key_init);
+    tss_set(thread_caches_key, tc);
+    tc->registered = true;
+  }
+
+  object_pool_cache_t* c = empty;
+  if (!c) {
+    c = &tc->entries[tc->next_victim++ % OBJECT_POOL_THREAD_CACHES];
+    cache_flush(c, c->count);
+  }
+  c->pool = pool;
+  return c;
+}
+
+texec_status_t texec_object_pool_create(const texec_object_pool_config_t* cfg, texec_object_pool_t** out_pool) {
+  if (!out_pool) return TEXEC_STATUS_INVALID_ARGUMENT;
+  *out_pool = NULL;
+
+  if (!cfg || !cfg->alloc || cfg->object_size == 0 || cfg->object_align == 0 || cfg->slab_capacity == 0) {
+    return TEXEC_STATUS_INVALID_ARGUMENT;
+  }
+
+  texec_object_pool_t* pool = texec_allocate(cfg->alloc, sizeof(*pool), _Alignof(texec_object_pool_t));
+  if (!pool) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  if (mtx_init(&pool->mtx, mtx_plain) != thrd_success) {
+    texec_free(cfg->alloc, pool, sizeof(*pool), _Alignof(texec_object_pool_t));
+    return TEXEC_STATUS_INTERNAL_ERROR;
+  }
+
+  const size_t slot_align = max_size(cfg->object_align, _Alignof(object_pool_slot_t));
+
+  pool->alloc = cfg->alloc;
+  pool->init = cfg->init;
+  pool->fini = cfg->fini;
+  pool->object_offset = round_up(sizeof(object_pool_slot_t), cfg->object_align);
+  pool->slot_stride = round_up(pool->object_offset + cfg->object_size, slot_align);
+  pool->slab_capacity = cfg->slab_capacity;
+  pool->slab_align = max_size(slot_align, _Alignof(object_pool_slab_t));
+  pool->slab_header_size = round_up(sizeof(object_pool_slab_t), slot_align);
+  pool->thread_cache_capacity = cfg->thread_cache_capacity;
+  pool->free_list = NULL;
+  pool->slabs = NULL;
+  pool->outstanding = 0;
+  atomic_init(&pool->released, false);
+
+  *out_pool = pool;
+  return TEXEC_STATUS_OK;
+}
+
+void texec_object_pool_release(texec_object_pool_t* pool) {
+  if (!pool) return;
+
+  // Give back what the releasing thread holds; other threads return theirs on exit.
+  for (size_t i = 0; i < OBJECT_POOL_THREAD_CACHES; ++i) {
+    object_pool_cache_t* c = &thread_caches.entries[i];
+    if (c->count != 0 && c->pool == pool) {
+      cache_flush(c, c->count);
+    }
+  }
+
+  mtx_lock(&pool->mtx);
+  atomic_store_explicit(&pool->released, true, memory_order_relaxed);
+  const bool destroy = pool->outstanding == 0;
+  mtx_unlock(&pool->mtx);
+
+  if (destroy) {
+    pool_destroy(pool);
+  }
+}
+
+const texec_allocator_t* texec_object_pool_allocator(const texec_object_pool_t* pool) {
+  return pool->alloc;
+}
+
+void* texec_object_pool_acquire(texec_object_pool_t* pool) {
+  if (pool->thread_cache_capacity == 0) {
+    object_pool_slot_t* slot = NULL;
+    return pool_take(pool, &slot, 1) ? object_from_slot(pool, slot) : NULL;
+  }
+
+  object_pool_cache_t* c = thread_cache_for(pool);
+  if (c->count == 0) {
+    const size_t batch = pool->thread_cache_capacity / 2 + 1;
+    c->count = pool_take(pool, &c->head, batch);
+    if (c->count == 0) return NULL;
+  }
+
+  object_pool_slot_t* slot = c->head;
+  c->head = slot->next;
+  c->count--;
+  return object_from_slot(pool, slot);
+}
+
+void texec_object_pool_recycle(texec_object_pool_t* pool, void* obj) {
+  object_pool_slot_t* slot = slot_from_object(pool, obj);
+
+  // Once the owner is gone, objects go straight back so the pool can be freed
+  if (pool->thread_cache_capacity == 0 || atomic_load_explicit(&pool->released, memory_order_relaxed)) {
+    pool_give_back(pool, slot, slot, 1);
+    return;
+  }
+
+  object_pool_cache_t* c = thread_cache_for(pool);
+  slot->next = c->head;
+  c->head = slot;
+  c->count++;
+
+  if (c->count > pool->thread_cache_capacity) {
+    cache_flush(c, c->count - pool->thread_cache_capacity / 2);
+  }
+}
@@ -0,0 +1,279 @@
+#include "texec/parallel.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "internal/allocator.h"
+#include "internal/executor.h"
+#include "internal/futex.h"
+#include "internal/help.h"
+
+// Chunks handed off per worker when the grain is picked automatically.
+static const size_t PARALLEL_AUTO_CHUNKS_PER_WORKER = 8;
+
+typedef struct parallel_job parallel_job_t;
+
+// A subrange handed off to the executor. Whoever claims it first (the task, or the caller while
+// it helps) processes it; the task may only find it claimed much later, so chunks are refcounted
+// between the task and the job and never reference the job once claimed by someone else.
+typedef struct parallel_chunk {
+  struct parallel_chunk* next; // job list, newest first
+  atomic_uint claimed;
+  atomic_uint refcount;
+  parallel_job_t* job;
+  const texec_allocator_t* alloc;
+  size_t alloc_size;
+  size_t alloc_align;
+  size_t begin;
+  size_t end;
+  void* acc; // partial result, reductions only
+} parallel_chunk_t;
+
+struct parallel_job {
+  texec_executor_t* ex;
+  size_t grain;
+  bool can_split;
+  texec_parallel_for_fn_t fn;           // either fn...
+  const texec_parallel_reducer_t* reducer; // ...or reducer
+  void* ctx;
+  _Atomic(parallel_chunk_t*) chunks;
+  atomic_size_t queued;     // handed off and not claimed yet
+  atomic_uint outstanding;  // chunks not finished, the root included; futex word the caller waits on
+};
+
+static inline size_t parallel_value_align(const texec_parallel_reducer_t* reducer) {
+  return reducer->value_align ? reducer->value_align : _Alignof(max_align_t);
+}
+
+static parallel_chunk_t* parallel_chunk_create(parallel_job_t* job, size_t begin, size_t end, unsigned int refcount) {
+  size_t size = sizeof(parallel_chunk_t);
+  size_t align = _Alignof(parallel_chunk_t);
+  size_t acc_offset = 0;
+  if (job->reducer) {
+    const size_t value_align = parallel_value_align(job->reducer);
+    acc_offset = (size + value_align - 1) & ~(value_align - 1);
+    size = acc_offset + job->reducer->value_size;
+    if (value_align > align) align = value_align;
+  }
+
+  parallel_chunk_t* c = texec_allocate(job->ex->alloc, size, align);
+  if (!c) return NULL;
+
+  c->next = NULL;
+  atomic_init(&c->claimed, 0u);
+  atomic_init(&c->refcount, refcount);
+  c->job = job;
+  c->alloc = job->ex->alloc;
+  c->alloc_size = size;
+  c->alloc_align = align;
+  c->begin = begin;
+  c->end = end;
+  c->acc = NULL;
+  if (job->reducer) {
+    c->acc = (unsigned char*)c + acc_offset;
+    memcpy(c->acc, job->reducer->identity, job->reducer->value_size);
+  }
+  return c;
+}
+
+static void parallel_chunk_release(parallel_chunk_t* c) {
+  if (atomic_fetch_sub_explicit(&c->refcount, 1u, memory_order_acq_rel) == 1u) {
+    texec_free(c->alloc, c, c->alloc_size, c->alloc_align);
+  }
+}
+
+static inline bool parallel_chunk_claim(parallel_chunk_t* c) {
+  return atomic_exchange_explicit(&c->claimed, 1u, memory_order_acq_rel) == 0u;
+}
+
+static void parallel_process(parallel_job_t* job, parallel_chunk_t* c);
+
+static int parallel_chunk_task(void* ctx) {
+  parallel_chunk_t* c = ctx;
+  if (parallel_chunk_claim(c)) {
+    parallel_job_t* job = c->job;
+    atomic_fetch_sub_explicit(&job->queued, 1, memory_order_relaxed);
+    parallel_process(job, c);
+  }
+  parallel_chunk_release(c);
+  return 0;
+}
+
+// Hands [begin, end) off to the executor. Returns false, leaving the range to the caller, if the
+// executor does not take it.
+static bool parallel_spawn(parallel_job_t* job, size_t begin, size_t end) {
+  parallel_chunk_t* c = parallel_chunk_create(job, begin, end, 2u); // the task's and the job's
+  if (!c) return false;
+
+  atomic_fetch_add_explicit(&job->queued, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&job->outstanding, 1u, memory_order_relaxed);
+
+  // Splitting is an optimization: never wait for room in the queue. The half is for other
+  // workers, so it must not sit in a worker's LIFO slot behind the chunk being processed.
+  const texec_structure_header_t shared = {TEXEC_STRUCT_TYPE_SUBMIT_INTERNAL_SHARED, NULL};
+  const texec_submit_backpressure_info_t reject = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE, &shared},
+    .backpressure = TEXEC_BACKPRESSURE_REJECT,
+  };
+  const texec_submit_info_t info = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_INFO, &reject},
+    .task = {.run = parallel_chunk_task, .ctx = c},
+  };
+  if (texec_executor_submit(job->ex, &info, NULL) != TEXEC_STATUS_OK) {
+    atomic_fetch_sub_explicit(&job->queued, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&job->outstanding, 1u, memory_order_relaxed);
+    texec_free(c->alloc, c, c->alloc_size, c->alloc_align);
+    return false;
+  }
+
+  // Published only once submitted, so that every listed chunk is finished by somebody
+  parallel_chunk_t* head = atomic_load_explicit(&job->chunks, memory_order_relaxed);
+  do {
+    c->next = head;
+  } while (!atomic_compare_exchange_weak_explicit(&job->chunks, &head, c, memory_order_release, memory_order_relaxed));
+  return true;
+}
+
+// Lazy binary splitting: before each grain-sized step, give away the upper half of what is left
+// if nobody has a handed-off chunk to pick up.
+static void parallel_process(parallel_job_t* job, parallel_chunk_t* c) {
+  size_t begin = c->begin;
+  size_t end = c->end;
+
+  while (begin < end) {
+    if (job->can_split && end - begin > job->grain && atomic_load_explicit(&job->queued, memory_order_relaxed) == 0) {
+      const size_t mid = begin + (end - begin) / 2;
+      if (parallel_spawn(job, mid, end)) {
+        end = mid;
+        continue;
+      }
+    }
+
+    const size_t step = end - begin < job->grain ? end - begin : job->grain;
+    if (job->reducer) {
+      job->reducer->fold(job->ctx, begin, begin + step, c->acc);
+    } else {
+      job->fn(job->ctx, begin, begin + step);
+    }
+    begin += step;
+  }
+
+  // Last access to the job from a task: the caller may return as soon as this reaches zero
+  if (atomic_fetch_sub_explicit(&job->outstanding, 1u, memory_order_acq_rel) == 1u) {
+    texec_futex_wake_all(&job->outstanding);
+  }
+}
+
+static size_t parallel_pick_grain(const texec_executor_t* ex, size_t count) {
+  size_t workers = 1;
+  texec_executor_query(ex, TEXEC_EXECUTOR_CAPABILITY_WORKER_COUNT, &workers);
+  const size_t chunks = (workers + 1) * PARALLEL_AUTO_CHUNKS_PER_WORKER;
+  return count / chunks ? count / chunks : 1;
+}
+
+// Sorts the job's chunks by their first index, so partial results combine in order.
+static parallel_chunk_t* parallel_sort_chunks(parallel_chunk_t* list) {
+  parallel_chunk_t* sorted = NULL;
+  while (list) {
+    parallel_chunk_t* c = list;
+    list = list->next;
+
+    parallel_chunk_t** at = &sorted;
+    while (*at && (*at)->begin < c->begin) at = &(*at)->next;
+    c->next = *at;
+    *at = c;
+  }
+  return sorted;
+}
+
+static texec_status_t parallel_run(parallel_job_t* job, size_t begin, size_t end, void* out_value) {
+  parallel_chunk_t* root = parallel_chunk_create(job, begin, end, 1u);
+  if (!root) return TEXEC_STATUS_OUT_OF_MEMORY;
+  atomic_store_explicit(&root->claimed, 1u, memory_order_relaxed);
+
+  atomic_fetch_add_explicit(&job->outstanding, 1u, memory_order_relaxed);
+  parallel_process(job, root);
+
+  // Help: take back handed-off chunks nobody has started yet
+  bool claimed_any = true;
+  while (claimed_any) {
+    claimed_any = false;
+    for (parallel_chunk_t* c = atomic_load_explicit(&job->chunks, memory_order_acquire); c; c = c->next) {
+      if (!parallel_chunk_claim(c)) continue;
+      atomic_fetch_sub_explicit(&job->queued, 1, memory_order_relaxed);
+      parallel_process(job, c);
+      claimed_any = true;
+    }
+  }
+
+  // Chunks in progress elsewhere; a worker calling in runs other queued tasks meanwhile
+  unsigned int outstanding = atomic_load_explicit(&job->outstanding, memory_order_acquire);
+  while (outstanding != 0u) {
+    if (!texec_help_run_one(UINT64_MAX)) texec_help_park(&job->outstanding, outstanding, UINT64_MAX);
+    outstanding = atomic_load_explicit(&job->outstanding, memory_order_acquire);
+  }
+
+  parallel_chunk_t* chunks = atomic_load_explicit(&job->chunks, memory_order_acquire);
+  root->next = chunks;
+  chunks = parallel_sort_chunks(root);
+
+  if (job->reducer) {
+    memcpy(out_value, job->reducer->identity, job->reducer->value_size);
+    for (parallel_chunk_t* c = chunks; c; c = c->next) job->reducer->combine(job->ctx, out_value, c->acc);
+  }
+
+  while (chunks) {
+    parallel_chunk_t* next = chunks->next;
+    parallel_chunk_release(chunks);
+    chunks = next;
+  }
+  return TEXEC_STATUS_OK;
+}
+
+static void parallel_job_init(parallel_job_t* job, texec_executor_t* ex, size_t count, size_t grain, void* ctx) {
+  job->ex = ex;
+  job->grain = grain ? grain : parallel_pick_grain(ex, count);
+  // Inline submits run the half right away, on this thread: nothing to gain from splitting
+  job->can_split = ex->kind != TEXEC_EXECUTOR_KIND_INLINE;
+  job->fn = NULL;
+  job->reducer = NULL;
+  job->ctx = ctx;
+  atomic_init(&job->chunks, NULL);
+  atomic_init(&job->queued, 0);
+  atomic_init(&job->outstanding, 0u);
+}
+
+texec_status_t texec_parallel_for(texec_executor_t* ex, size_t begin, size_t end, size_t grain, texec_parallel_for_fn_t fn, void* ctx) {
+  if (!ex || !fn || begin > end) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (begin == end) return TEXEC_STATUS_OK;
+
+  parallel_job_t job;
+  parallel_job_init(&job, ex, end - begin, grain, ctx);
+  job.fn = fn;
+  return parallel_run(&job, begin, end, NULL);
+}
+
+texec_status_t texec_parallel_reduce(texec_executor_t* ex,
+                                     size_t begin,
+                                     size_t end,
+                                     size_t grain,
+                                     const texec_parallel_reducer_t* reducer,
+                                     void* ctx,
+                                     void* out_value) {
+  if (!ex || !reducer || !out_value || begin > end) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (!reducer->fold || !reducer->combine || (reducer->value_size && !reducer->identity)) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (reducer->value_align & (reducer->value_align - 1)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (begin == end) {
+    memcpy(out_value, reducer->identity, reducer->value_size);
+    return TEXEC_STATUS_OK;
+  }
+
+  parallel_job_t job;
+  parallel_job_init(&job, ex, end - begin, grain, ctx);
+  job.reducer = reducer;
+  return parallel_run(&job, begin, end, out_value);
+}
@@ -0,0 +1,209 @@
+#include "internal/placement.h"
+
+#include <stdint.h>
+
+#include "internal/allocator.h"
+#include "internal/topology.h"
+
+static bool placement_contains(const unsigned int* cpus, size_t count, unsigned int cpu) {
+  for (size_t i = 0; i < count; ++i) {
+    if (cpus[i] == cpu) return true;
+  }
+  return false;
+}
+
+// Collects the CPUs the pool may use into `out` (ascending, no duplicates): the listed CPUs the
+// creating thread may also run on, or all of the latter when none are listed.
+static size_t placement_collect_cpus(const texec_executor_create_affinity_info_t* info,
+                                     const unsigned int* available,
+                                     size_t available_count,
+                                     unsigned int* out) {
+  if (!info->cpus) {
+    for (size_t i = 0; i < available_count; ++i) out[i] = available[i];
+    return available_count;
+  }
+
+  size_t count = 0;
+  for (size_t i = 0; i < info->cpu_count && count < TEXEC_TOPOLOGY_MAX_CPUS; ++i) {
+    const unsigned int cpu = info->cpus[i];
+    if (placement_contains(out, count, cpu)) continue;
+    if (available_count && !placement_contains(available, available_count, cpu)) continue;
+
+    size_t j = count++;
+    for (; j > 0 && out[j - 1] > cpu; --j) out[j] = out[j - 1];
+    out[j] = cpu;
+  }
+  return count;
+}
+
+static inline bool placement_validate(const texec_executor_create_affinity_info_t* info) {
+  if (info->cpus && info->cpu_count == 0) return false;
+  return info->pinning == TEXEC_WORKER_PINNING_NONE
+      || info->pinning == TEXEC_WORKER_PINNING_NODE
+      || info->pinning == TEXEC_WORKER_PINNING_CPU;
+}
+
+size_t texec_placement_usable_cpu_count(const texec_executor_create_affinity_info_t* info) {
+  unsigned int available[TEXEC_TOPOLOGY_MAX_CPUS];
+  unsigned int usable[TEXEC_TOPOLOGY_MAX_CPUS];
+  const size_t available_count = texec_topology_available_cpus(available, TEXEC_TOPOLOGY_MAX_CPUS);
+
+  // Without an affinity mask to check against, only a listed set tells how many CPUs there are
+  size_t count = (info->cpus || available_count) ? placement_collect_cpus(info, available, available_count, usable) : 0;
+
+  const size_t quota = texec_topology_cpu_quota();
+  if (quota && (count == 0 || quota < count)) count = quota;
+  return count;
+}
+
+static void* placement_array(const texec_placement_t* p, size_t count, size_t size, size_t align) {
+  return texec_allocate(p->alloc, count * size, align);
+}
+
+void texec_placement_destroy(texec_placement_t* p) {
+  if (p->cpus) texec_free(p->alloc, p->cpus, p->cpu_count * sizeof(unsigned int), _Alignof(unsigned int));
+  if (p->group_first) texec_free(p->alloc, p->group_first, (p->group_count + 1) * sizeof(size_t), _Alignof(size_t));
+  if (p->group_nodes) texec_free(p->alloc, p->group_nodes, p->group_count * sizeof(unsigned int), _Alignof(unsigned int));
+  if (p->cpu_groups) texec_free(p->alloc, p->cpu_groups, p->cpu_groups_length * sizeof(size_t), _Alignof(size_t));
+  if (p->creator_cpus) texec_free(p->alloc, p->creator_cpus, p->creator_cpu_count * sizeof(unsigned int), _Alignof(unsigned int));
+
+  p->cpus = NULL;
+  p->group_first = NULL;
+  p->group_nodes = NULL;
+  p->cpu_groups = NULL;
+  p->creator_cpus = NULL;
+  p->group_count = 0;
+}
+
+texec_status_t texec_placement_init(texec_placement_t* p, const texec_executor_create_affinity_info_t* info, const texec_allocator_t* alloc) {
+  *p = (texec_placement_t){.pinning = TEXEC_WORKER_PINNING_NONE, .alloc = alloc};
+  if (!info) return TEXEC_STATUS_OK;
+  if (!placement_validate(info)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  unsigned int available[TEXEC_TOPOLOGY_MAX_CPUS];
+  unsigned int usable[TEXEC_TOPOLOGY_MAX_CPUS];
+  unsigned int nodes[TEXEC_TOPOLOGY_MAX_CPUS];
+  const size_t available_count = texec_topology_available_cpus(available, TEXEC_TOPOLOGY_MAX_CPUS);
+
+  // Nothing can be placed without affinity support
+  if (available_count == 0) return TEXEC_STATUS_OK;
+
+  const size_t count = placement_collect_cpus(info, available, available_count, usable);
+  if (count == 0) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  // Stable sort by node keeps CPUs ascending within each group
+  for (size_t i = 0; i < count; ++i) {
+    const unsigned int cpu = usable[i];
+    const unsigned int node = texec_topology_cpu_node(cpu);
+    size_t j = i;
+    for (; j > 0 && nodes[j - 1] > node; --j) {
+      usable[j] = usable[j - 1];
+      nodes[j] = nodes[j - 1];
+    }
+    usable[j] = cpu;
+    nodes[j] = node;
+  }
+
+  size_t group_count = 1;
+  unsigned int max_cpu = usable[0];
+  for (size_t i = 1; i < count; ++i) {
+    group_count += (nodes[i] != nodes[i - 1]);
+    if (usable[i] > max_cpu) max_cpu = usable[i];
+  }
+
+  p->cpu_count = count;
+  p->group_count = group_count;
+  p->cpu_groups_length = (size_t)max_cpu + 1;
+  p->creator_cpu_count = available_count;
+  p->pinning = info->pinning;
+  p->restrict_workers = info->cpus != NULL;
+
+  p->cpus = placement_array(p, count, sizeof(unsigned int), _Alignof(unsigned int));
+  p->group_first = placement_array(p, group_count + 1, sizeof(size_t), _Alignof(size_t));
+  p->group_nodes = placement_array(p, group_count, sizeof(unsigned int), _Alignof(unsigned int));
+  p->cpu_groups = placement_array(p, p->cpu_groups_length, sizeof(size_t), _Alignof(size_t));
+  p->creator_cpus = placement_array(p, available_count, sizeof(unsigned int), _Alignof(unsigned int));
+  if (!p->cpus || !p->group_first || !p->group_nodes || !p->cpu_groups || !p->creator_cpus) {
+    texec_placement_destroy(p);
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+
+  for (size_t i = 0; i < available_count; ++i) p->creator_cpus[i] = available[i];
+  for (size_t cpu = 0; cpu < p->cpu_groups_length; ++cpu) p->cpu_groups[cpu] = SIZE_MAX;
+
+  size_t group = 0;
+  p->group_first[0] = 0;
+  p->group_nodes[0] = nodes[0];
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0 && nodes[i] != nodes[i - 1]) {
+      p->group_first[++group] = i;
+      p->group_nodes[group] = nodes[i];
+    }
+    p->cpus[i] = usable[i];
+    p->cpu_groups[usable[i]] = group;
+  }
+  p->group_first[group_count] = count;
+
+  return TEXEC_STATUS_OK;
+}
+
+void texec_placement_worker_cpus(const texec_placement_t* p, size_t worker_index, const unsigned int** out_cpus, size_t* out_count) {
+  *out_cpus = NULL;
+  *out_count = 0;
+  if (p->group_count == 0) return;
+
+  const size_t group = texec_placement_worker_group(p, worker_index);
+  const size_t first = p->group_first[group];
+  const size_t size = p->group_first[group + 1] - first;
+
+  switch (p->pinning) {
+  case TEXEC_WORKER_PINNING_CPU:
+    // Successive workers of a group take its CPUs in turn
+    *out_cpus = &p->cpus[first + (worker_index / p->group_count) % size];
+    *out_count = 1;
+    break;
+
+  case TEXEC_WORKER_PINNING_NODE:
+    *out_cpus = &p->cpus[first];
+    *out_count = size;
+    break;
+
+  default:
+    if (p->restrict_workers) {
+      *out_cpus = p->cpus;
+      *out_count = p->cpu_count;
+    }
+    break;
+  }
+}
+
+size_t texec_placement_current_group(const texec_placement_t* p) {
+  if (p->group_count <= 1) return 0;
+
+  unsigned int cpu = 0;
+  if (!texec_topology_current_cpu(&cpu) || cpu >= p->cpu_groups_length) return 0;
+
+  const size_t group = p->cpu_groups[cpu];
+  return group == SIZE_MAX ? 0 : group;
+}
+
+bool texec_placement_find_node(const texec_placement_t* p, unsigned int node, size_t* out_group) {
+  for (size_t group = 0; group < p->group_count; ++group) {
+    if (p->group_nodes[group] == node) {
+      *out_group = group;
+      return true;
+    }
+  }
+  return false;
+}
+
+void texec_placement_enter_group(const texec_placement_t* p, size_t group) {
+  if (p->group_count == 0) return;
+  const size_t first = p->group_first[group];
+  texec_topology_pin_current_thread(&p->cpus[first], p->group_first[group + 1] - first);
+}
+
+void texec_placement_leave_group(const texec_placement_t* p) {
+  if (p->creator_cpu_count == 0) return;
+  texec_topology_pin_current_thread(p->creator_cpus, p->creator_cpu_count);
+}
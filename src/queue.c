@@ -1,6 +1,7 @@
 #include "texec/queue.h"
 
 #include <stdbool.h>
+#include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -8,18 +9,31 @@
 #include <threads.h>
 
 #include "internal/allocator.h"
+#include "internal/cache_line.h"
+#include "internal/event_count.h"
+#include "internal/mpmc_ring.h"
 
 struct texec_queue {
+  texec_queue_mode_t mode;
+  const texec_allocator_t* alloc;
+
+  // TEXEC_QUEUE_MODE_LOCKED
   mtx_t mtx;
   cnd_t not_empty;
   cnd_t not_full;
-  const texec_allocator_t* alloc;
   uintptr_t* buf;
   size_t head;
   size_t tail;
   size_t count;
   size_t capacity;
+  size_t not_empty_waiters;
+  size_t not_full_waiters;
   bool closed;
+
+  // TEXEC_QUEUE_MODE_LOCK_FREE: only threads that find the ring full/empty park here
+  texec_mpmc_ring_t ring;
+  TEXEC_CACHE_ALIGNED texec_event_count_t ring_not_empty;
+  texec_event_count_t ring_not_full;
 };
 
 static inline bool queue_init_cnds(texec_queue_t* q) {
@@ -44,7 +58,7 @@ static inline bool queue_init_sync_prims(texec_queue_t* q) {
   return true;
 }
 
-static inline texec_status_t queue_init(texec_queue_t* q, size_t capacity, const texec_allocator_t* alloc) {
+static inline texec_status_t queue_init_locked(texec_queue_t* q, size_t capacity, const texec_allocator_t* alloc) {
   uintptr_t* qbuf = texec_allocate(alloc, capacity * sizeof(uintptr_t), _Alignof(uintptr_t));
   if (!qbuf) return TEXEC_STATUS_OUT_OF_MEMORY;
 
@@ -53,17 +67,42 @@ static inline texec_status_t queue_init(texec_queue_t* q, size_t capacity, const
     return TEXEC_STATUS_INTERNAL_ERROR;
   }
 
-  q->alloc = alloc;
   q->buf = qbuf;
   q->head = 0;
   q->tail = 0;
   q->count = 0;
   q->capacity = capacity;
+  q->not_empty_waiters = 0;
+  q->not_full_waiters = 0;
   q->closed = false;
 
   return TEXEC_STATUS_OK;
 }
 
+static inline texec_status_t queue_init_lock_free(texec_queue_t* q, size_t capacity, const texec_allocator_t* alloc) {
+  texec_status_t st = texec_mpmc_ring_init(&q->ring, capacity, alloc);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  texec_event_count_init(&q->ring_not_empty);
+  texec_event_count_init(&q->ring_not_full);
+  q->capacity = texec_mpmc_ring_capacity(&q->ring);
+  return TEXEC_STATUS_OK;
+}
+
+static inline texec_status_t queue_init(texec_queue_t* q, size_t capacity, texec_queue_mode_t mode, const texec_allocator_t* alloc) {
+  q->mode = mode;
+  q->alloc = alloc;
+
+  switch (mode) {
+  case TEXEC_QUEUE_MODE_LOCKED:
+    return queue_init_locked(q, capacity, alloc);
+  case TEXEC_QUEUE_MODE_LOCK_FREE:
+    return queue_init_lock_free(q, capacity, alloc);
+  default:
+    return TEXEC_STATUS_INVALID_ARGUMENT;
+  }
+}
+
 static inline texec_status_t queue_unlock_return(texec_queue_t* q, texec_status_t st) {
   mtx_unlock(&q->mtx);
   return st;
@@ -90,16 +129,41 @@ static inline bool queue_is_empty(const texec_queue_t* q) {
   return q->count == 0;
 }
 
-static inline texec_status_t queue_push_impl(texec_queue_t* q, uintptr_t item, bool wait_not_full) {
-  if (!q) return TEXEC_STATUS_INVALID_ARGUMENT;
+static inline void queue_wait_not_full(texec_queue_t* q) {
+  q->not_full_waiters++;
+  cnd_wait(&q->not_full, &q->mtx);
+  q->not_full_waiters--;
+}
 
+static inline void queue_wait_not_empty(texec_queue_t* q) {
+  q->not_empty_waiters++;
+  cnd_wait(&q->not_empty, &q->mtx);
+  q->not_empty_waiters--;
+}
+
+// Wakes just enough of `waiters` threads blocked on `cnd` to consume `n` state changes
+static inline void queue_signal_n(cnd_t* cnd, size_t waiters, size_t n) {
+  if (n >= waiters) {
+    if (waiters) cnd_broadcast(cnd);
+    return;
+  }
+  while (n--) {
+    cnd_signal(cnd);
+  }
+}
+
+static inline unsigned int queue_wake_count(size_t n) {
+  return n < UINT_MAX ? (unsigned int)n : UINT_MAX;
+}
+
+static inline texec_status_t queue_push_locked(texec_queue_t* q, uintptr_t item, bool wait_not_full) {
   mtx_lock(&q->mtx);
 
   while (!q->closed && queue_is_full(q)) {
     if (!wait_not_full) {
       return queue_unlock_return(q, TEXEC_STATUS_REJECTED);
     }
-    cnd_wait(&q->not_full, &q->mtx);
+    queue_wait_not_full(q);
   }
 
   if (q->closed) {
@@ -108,21 +172,19 @@ static inline texec_status_t queue_push_impl(texec_queue_t* q, uintptr_t item, b
 
   queue_push_item(q, item);
 
-  cnd_signal(&q->not_empty);
+  queue_signal_n(&q->not_empty, q->not_empty_waiters, 1);
   mtx_unlock(&q->mtx);
   return TEXEC_STATUS_OK;
 }
 
-static inline texec_status_t queue_pop_impl(texec_queue_t* q, uintptr_t* out_item, bool wait_not_empty) {
-  if (!q || !out_item) return TEXEC_STATUS_INVALID_ARGUMENT;
-
+static inline texec_status_t queue_pop_locked(texec_queue_t* q, uintptr_t* out_item, bool wait_not_empty) {
   mtx_lock(&q->mtx);
 
   while (!q->closed && queue_is_empty(q)) {
     if (!wait_not_empty) {
       return queue_unlock_return(q, TEXEC_STATUS_REJECTED);
     }
-    cnd_wait(&q->not_empty, &q->mtx);
+    queue_wait_not_empty(q);
   }
 
   if (q->closed && queue_is_empty(q)) {
@@ -131,11 +193,206 @@ static inline texec_status_t queue_pop_impl(texec_queue_t* q, uintptr_t* out_ite
 
   *out_item = queue_pop_item(q);
 
-  cnd_signal(&q->not_full);
+  queue_signal_n(&q->not_full, q->not_full_waiters, 1);
+  mtx_unlock(&q->mtx);
+  return TEXEC_STATUS_OK;
+}
+
+static inline texec_status_t queue_push_many_locked(texec_queue_t* q, const uintptr_t* items, size_t count, size_t* out_pushed, bool wait_not_full) {
+  texec_status_t st = TEXEC_STATUS_OK;
+  size_t pushed = 0;
+
+  mtx_lock(&q->mtx);
+
+  while (pushed < count) {
+    while (!q->closed && queue_is_full(q) && wait_not_full) {
+      queue_wait_not_full(q);
+    }
+
+    if (q->closed) {
+      st = TEXEC_STATUS_CLOSED;
+      break;
+    }
+
+    if (queue_is_full(q)) {
+      st = TEXEC_STATUS_REJECTED;
+      break;
+    }
+
+    const size_t first = pushed;
+    while (pushed < count && !queue_is_full(q)) {
+      queue_push_item(q, items[pushed++]);
+    }
+    queue_signal_n(&q->not_empty, q->not_empty_waiters, pushed - first);
+  }
+
   mtx_unlock(&q->mtx);
+
+  *out_pushed = pushed;
+  return st;
+}
+
+static inline texec_status_t queue_pop_many_locked(texec_queue_t* q, uintptr_t* out_items, size_t max_count, size_t* out_popped, bool wait_not_empty) {
+  mtx_lock(&q->mtx);
+
+  while (!q->closed && queue_is_empty(q)) {
+    if (!wait_not_empty) {
+      return queue_unlock_return(q, TEXEC_STATUS_REJECTED);
+    }
+    queue_wait_not_empty(q);
+  }
+
+  if (q->closed && queue_is_empty(q)) {
+    return queue_unlock_return(q, TEXEC_STATUS_CLOSED);
+  }
+
+  size_t n = 0;
+  while (n < max_count && !queue_is_empty(q)) {
+    out_items[n++] = queue_pop_item(q);
+  }
+
+  queue_signal_n(&q->not_full, q->not_full_waiters, n);
+  mtx_unlock(&q->mtx);
+
+  *out_popped = n;
   return TEXEC_STATUS_OK;
 }
 
+static inline texec_status_t queue_push_lock_free(texec_queue_t* q, uintptr_t item, bool wait_not_full) {
+  texec_status_t st = texec_mpmc_ring_try_push(&q->ring, item);
+
+  while (st == TEXEC_STATUS_REJECTED && wait_not_full) {
+    const unsigned int key = texec_event_count_prepare_wait(&q->ring_not_full);
+    st = texec_mpmc_ring_try_push(&q->ring, item);
+    if (st != TEXEC_STATUS_REJECTED) {
+      texec_event_count_cancel_wait(&q->ring_not_full);
+      break;
+    }
+    texec_event_count_wait(&q->ring_not_full, key);
+    st = texec_mpmc_ring_try_push(&q->ring, item);
+  }
+
+  if (st == TEXEC_STATUS_OK) {
+    texec_event_count_notify_one(&q->ring_not_empty);
+  }
+  return st;
+}
+
+static inline texec_status_t queue_pop_lock_free(texec_queue_t* q, uintptr_t* out_item, bool wait_not_empty) {
+  texec_status_t st = texec_mpmc_ring_try_pop(&q->ring, out_item);
+
+  while (st == TEXEC_STATUS_REJECTED && wait_not_empty) {
+    const unsigned int key = texec_event_count_prepare_wait(&q->ring_not_empty);
+    st = texec_mpmc_ring_try_pop(&q->ring, out_item);
+    if (st != TEXEC_STATUS_REJECTED) {
+      texec_event_count_cancel_wait(&q->ring_not_empty);
+      break;
+    }
+    texec_event_count_wait(&q->ring_not_empty, key);
+    st = texec_mpmc_ring_try_pop(&q->ring, out_item);
+  }
+
+  if (st == TEXEC_STATUS_OK) {
+    texec_event_count_notify_one(&q->ring_not_full);
+  }
+  return st;
+}
+
+static inline texec_status_t queue_push_many_lock_free(texec_queue_t* q, const uintptr_t* items, size_t count, size_t* out_pushed, bool wait_not_full) {
+  texec_status_t st = TEXEC_STATUS_OK;
+  size_t pushed = 0;
+
+  while (pushed < count) {
+    size_t n = 0;
+    st = texec_mpmc_ring_try_push_many(&q->ring, items + pushed, count - pushed, &n);
+
+    if (st == TEXEC_STATUS_REJECTED && wait_not_full) {
+      const unsigned int key = texec_event_count_prepare_wait(&q->ring_not_full);
+      st = texec_mpmc_ring_try_push_many(&q->ring, items + pushed, count - pushed, &n);
+      if (st == TEXEC_STATUS_REJECTED) {
+        texec_event_count_wait(&q->ring_not_full, key);
+        continue;
+      }
+      texec_event_count_cancel_wait(&q->ring_not_full);
+    }
+
+    if (st != TEXEC_STATUS_OK) break;
+
+    pushed += n;
+    texec_event_count_notify_many(&q->ring_not_empty, queue_wake_count(n));
+  }
+
+  *out_pushed = pushed;
+  return st;
+}
+
+static inline texec_status_t queue_pop_many_lock_free(texec_queue_t* q, uintptr_t* out_items, size_t max_count, size_t* out_popped, bool wait_not_empty) {
+  texec_status_t st = texec_mpmc_ring_try_pop_many(&q->ring, out_items, max_count, out_popped);
+
+  while (st == TEXEC_STATUS_REJECTED && wait_not_empty) {
+    const unsigned int key = texec_event_count_prepare_wait(&q->ring_not_empty);
+    st = texec_mpmc_ring_try_pop_many(&q->ring, out_items, max_count, out_popped);
+    if (st != TEXEC_STATUS_REJECTED) {
+      texec_event_count_cancel_wait(&q->ring_not_empty);
+      break;
+    }
+    texec_event_count_wait(&q->ring_not_empty, key);
+    st = texec_mpmc_ring_try_pop_many(&q->ring, out_items, max_count, out_popped);
+  }
+
+  if (st == TEXEC_STATUS_OK) {
+    texec_event_count_notify_many(&q->ring_not_full, queue_wake_count(*out_popped));
+  }
+  return st;
+}
+
+static inline texec_status_t queue_push_impl(texec_queue_t* q, uintptr_t item, bool wait_not_full) {
+  if (!q) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (q->mode == TEXEC_QUEUE_MODE_LOCK_FREE) {
+    return queue_push_lock_free(q, item, wait_not_full);
+  }
+  return queue_push_locked(q, item, wait_not_full);
+}
+
+static inline texec_status_t queue_pop_impl(texec_queue_t* q, uintptr_t* out_item, bool wait_not_empty) {
+  if (!q || !out_item) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (q->mode == TEXEC_QUEUE_MODE_LOCK_FREE) {
+    return queue_pop_lock_free(q, out_item, wait_not_empty);
+  }
+  return queue_pop_locked(q, out_item, wait_not_empty);
+}
+
+static inline texec_status_t queue_push_many_impl(texec_queue_t* q, const uintptr_t* items, size_t count, size_t* out_pushed, bool wait_not_full) {
+  size_t pushed = 0;
+  if (!out_pushed) out_pushed = &pushed;
+  *out_pushed = 0;
+
+  if (!q || (!items && count)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (q->mode == TEXEC_QUEUE_MODE_LOCK_FREE) {
+    return queue_push_many_lock_free(q, items, count, out_pushed, wait_not_full);
+  }
+  return queue_push_many_locked(q, items, count, out_pushed, wait_not_full);
+}
+
+static inline texec_status_t queue_pop_many_impl(texec_queue_t* q, uintptr_t* out_items, size_t max_count, size_t* out_popped, bool wait_not_empty) {
+  if (!out_popped) return TEXEC_STATUS_INVALID_ARGUMENT;
+  *out_popped = 0;
+
+  if (!q || !out_items || max_count == 0) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (q->mode == TEXEC_QUEUE_MODE_LOCK_FREE) {
+    return queue_pop_many_lock_free(q, out_items, max_count, out_popped, wait_not_empty);
+  }
+  return queue_pop_many_locked(q, out_items, max_count, out_popped, wait_not_empty);
+}
+
+static inline const texec_queue_create_mode_info_t* find_queue_mode_info(const texec_queue_create_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_QUEUE_CREATE_MODE_INFO);
+}
+
 texec_status_t texec_queue_create(const texec_queue_create_info_t* info, const texec_allocator_t* alloc, texec_queue_t** out_q) {
   if (!out_q) return TEXEC_STATUS_INVALID_ARGUMENT;
 
@@ -152,7 +409,10 @@ texec_status_t texec_queue_create(const texec_queue_create_info_t* info, const t
   texec_queue_t* q = texec_allocate(alloc, sizeof(*q), _Alignof(texec_queue_t));
   if (!q) return TEXEC_STATUS_OUT_OF_MEMORY;
 
-  texec_status_t st = queue_init(q, info->capacity, alloc);
+  const texec_queue_create_mode_info_t* mode_info = find_queue_mode_info(info);
+  const texec_queue_mode_t mode = mode_info ? mode_info->mode : TEXEC_QUEUE_MODE_LOCKED;
+
+  texec_status_t st = queue_init(q, info->capacity, mode, alloc);
   if (st != TEXEC_STATUS_OK) {
     texec_free(alloc, q, sizeof(*q), _Alignof(texec_queue_t));
   } else {
@@ -161,9 +421,22 @@ texec_status_t texec_queue_create(const texec_queue_create_info_t* info, const t
   return st;
 }
 
+static inline texec_status_t queue_destroy_lock_free(texec_queue_t* q) {
+  if (!texec_mpmc_ring_is_closed(&q->ring)) return TEXEC_STATUS_BUSY;
+
+  texec_mpmc_ring_destroy(&q->ring, q->alloc);
+  texec_free(q->alloc, q, sizeof(*q), _Alignof(texec_queue_t));
+
+  return TEXEC_STATUS_OK;
+}
+
 texec_status_t texec_queue_destroy(texec_queue_t* q) {
   if (!q) return TEXEC_STATUS_INVALID_ARGUMENT;
 
+  if (q->mode == TEXEC_QUEUE_MODE_LOCK_FREE) {
+    return queue_destroy_lock_free(q);
+  }
+
   mtx_lock(&q->mtx);
   const bool closed = q->closed;
   mtx_unlock(&q->mtx);
@@ -182,6 +455,14 @@ texec_status_t texec_queue_destroy(texec_queue_t* q) {
 
 void texec_queue_close(texec_queue_t* q) {
   if (!q) return;
+
+  if (q->mode == TEXEC_QUEUE_MODE_LOCK_FREE) {
+    texec_mpmc_ring_close(&q->ring);
+    texec_event_count_notify_all(&q->ring_not_empty);
+    texec_event_count_notify_all(&q->ring_not_full);
+    return;
+  }
+
   mtx_lock(&q->mtx);
   if (!q->closed) {
     cnd_broadcast(&q->not_empty);
@@ -191,6 +472,19 @@ void texec_queue_close(texec_queue_t* q) {
   mtx_unlock(&q->mtx);
 }
 
+size_t texec_queue_size(texec_queue_t* q) {
+  if (!q) return 0;
+
+  if (q->mode == TEXEC_QUEUE_MODE_LOCK_FREE) {
+    return texec_mpmc_ring_size(&q->ring);
+  }
+
+  mtx_lock(&q->mtx);
+  const size_t count = q->count;
+  mtx_unlock(&q->mtx);
+  return count;
+}
+
 texec_status_t texec_queue_try_push(texec_queue_t* q, uintptr_t item) {
   return queue_push_impl(q, item, false);
 }
@@ -206,3 +500,19 @@ texec_status_t texec_queue_push(texec_queue_t* q, uintptr_t item) {
 texec_status_t texec_queue_pop(texec_queue_t* q, uintptr_t* out_item) {
   return queue_pop_impl(q, out_item, true);
 }
+
+texec_status_t texec_queue_try_push_many(texec_queue_t* q, const uintptr_t* items, size_t count, size_t* out_pushed) {
+  return queue_push_many_impl(q, items, count, out_pushed, false);
+}
+
+texec_status_t texec_queue_push_many(texec_queue_t* q, const uintptr_t* items, size_t count, size_t* out_pushed) {
+  return queue_push_many_impl(q, items, count, out_pushed, true);
+}
+
+texec_status_t texec_queue_try_pop_many(texec_queue_t* q, uintptr_t* out_items, size_t max_count, size_t* out_popped) {
+  return queue_pop_many_impl(q, out_items, max_count, out_popped, false);
+}
+
+texec_status_t texec_queue_pop_many(texec_queue_t* q, uintptr_t* out_items, size_t max_count, size_t* out_popped) {
+  return queue_pop_many_impl(q, out_items, max_count, out_popped, true);
+}
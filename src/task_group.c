@@ -1,23 +1,47 @@
-#include "texec/task_group.h"
+#include "internal/task_group.h"
 
 #include <assert.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <threads.h>
 #include <string.h>
 
+#include "texec/clock.h"
+
 #include "internal/allocator.h"
+#include "internal/futex.h"
+#include "internal/help.h"
+#include "internal/spin.h"
 
 static const size_t TASK_GROUP_DEFAULT_CAPACITY = 8;
 static const float TASK_GROUP_EXPANSION_FACTOR = 1.5f;
+static const unsigned int TASK_GROUP_SPIN_COUNT = 64;
+
+// Layout of texec_task_group::state
+#define TASK_GROUP_WAITERS 1u
+#define TASK_GROUP_ORPHANED 2u // destroyed while counted tasks were pending
+#define TASK_GROUP_PENDING_SHIFT 2
+#define TASK_GROUP_PENDING_ONE (1u << TASK_GROUP_PENDING_SHIFT)
+#define TASK_GROUP_MAX_PENDING (UINT_MAX >> TASK_GROUP_PENDING_SHIFT)
 
 struct texec_task_group {
   mtx_t mtx;
   const texec_allocator_t* alloc;
-  texec_task_handle_t** handles;
+  texec_task_handle_t** handles; // allocated on first add
   size_t count;
   size_t capacity;
   bool closed;
+  texec_task_group_aggregate_t aggregate;
+  atomic_llong result;
+  atomic_uint state; // pending count << TASK_GROUP_PENDING_SHIFT | flags
+  texec_cancel_token_t* cancel; // attached to counted tasks; NULL if none
 };
 
+static inline unsigned int task_group_pending(unsigned int state) {
+  return state >> TASK_GROUP_PENDING_SHIFT;
+}
+
 static inline texec_task_handle_t** alloc_task_handles(const texec_allocator_t* alloc, size_t n) {
   return texec_allocate(alloc, n * sizeof(texec_task_handle_t*), _Alignof(texec_task_handle_t*));
 }
@@ -27,11 +51,13 @@ static inline void free_task_handles(const texec_allocator_t* alloc, texec_task_
 }
 
 static inline bool task_group_ensure_capacity(texec_task_group_t* g, size_t min_capacity) {
-  if (g->capacity >= min_capacity) return true;
+  if (g->handles && g->capacity >= min_capacity) return true;
 
+  // `capacity` is only a reservation hint until the array exists
   size_t new_cap = g->capacity;
   while (new_cap < min_capacity) {
     size_t next = (size_t)(new_cap * TASK_GROUP_EXPANSION_FACTOR);
+    if (next <= new_cap) next = new_cap + 1;
     if (next < new_cap) return false; // overflow
     new_cap = next;
   }
@@ -52,25 +78,74 @@ static inline bool task_group_ensure_capacity(texec_task_group_t* g, size_t min_
   return true;
 }
 
-static inline texec_status_t task_group_init(texec_task_group_t* g, size_t capacity, const texec_allocator_t* alloc) {
+static inline texec_status_t task_group_init(texec_task_group_t* g,
+                                             size_t capacity,
+                                             texec_task_group_aggregate_t aggregate,
+                                             texec_cancel_token_t* cancel,
+                                             const texec_allocator_t* alloc) {
   assert(capacity != 0);
 
-  if (mtx_init(&g->mtx, mtx_plain) != thrd_success) return TEXEC_STATUS_INTERNAL_ERROR;
-
-  texec_task_handle_t** handles = alloc_task_handles(alloc, capacity);
-  if (!handles) {
-    mtx_destroy(&g->mtx);
-    return TEXEC_STATUS_OUT_OF_MEMORY;
+  if (cancel && texec_cancel_token_retain(cancel) != TEXEC_STATUS_OK) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (mtx_init(&g->mtx, mtx_plain) != thrd_success) {
+    texec_cancel_token_release(cancel);
+    return TEXEC_STATUS_INTERNAL_ERROR;
   }
 
   g->alloc = alloc;
-  g->handles = handles;
+  g->handles = NULL;
   g->count = 0;
   g->capacity = capacity;
   g->closed = false;
+  g->aggregate = aggregate;
+  atomic_init(&g->result, 0);
+  atomic_init(&g->state, 0u);
+  g->cancel = cancel;
   return TEXEC_STATUS_OK;
 }
 
+static void task_group_free(texec_task_group_t* g) {
+  texec_cancel_token_release(g->cancel);
+  mtx_destroy(&g->mtx);
+  texec_free(g->alloc, g, sizeof(*g), _Alignof(texec_task_group_t));
+}
+
+// Returns false if `deadline_ns` passed while counted tasks were still pending. A pool worker
+// runs queued tasks meanwhile.
+static bool task_group_wait_pending(texec_task_group_t* g, uint64_t deadline_ns) {
+  unsigned int s = atomic_load_explicit(&g->state, memory_order_acquire);
+
+  for (unsigned int i = 0; i < TASK_GROUP_SPIN_COUNT && task_group_pending(s) != 0; ++i) {
+    texec_cpu_relax();
+    s = atomic_load_explicit(&g->state, memory_order_acquire);
+  }
+
+  for (;;) {
+    if (task_group_pending(s) == 0) {
+      // Every waiter that set the bit was parked on a non-zero count, so it is safe to drop
+      if (s & TASK_GROUP_WAITERS) {
+        atomic_compare_exchange_strong_explicit(&g->state, &s, s & ~TASK_GROUP_WAITERS, memory_order_relaxed, memory_order_relaxed);
+      }
+      return true;
+    }
+
+    if (texec_help_run_one(deadline_ns)) {
+      s = atomic_load_explicit(&g->state, memory_order_acquire);
+      continue;
+    }
+
+    if (!(s & TASK_GROUP_WAITERS)) {
+      if (!atomic_compare_exchange_weak_explicit(&g->state, &s, s | TASK_GROUP_WAITERS, memory_order_acquire, memory_order_acquire)) {
+        continue;
+      }
+      s |= TASK_GROUP_WAITERS;
+    }
+
+    // A waiter that times out leaves the bit set; the last task then issues one wake too many
+    if (!texec_help_park(&g->state, s, deadline_ns)) return false;
+    s = atomic_load_explicit(&g->state, memory_order_acquire);
+  }
+}
+
 static inline texec_status_t task_group_unlock_return(texec_task_group_t* g, texec_status_t st) {
   mtx_unlock(&g->mtx);
   return st;
@@ -91,8 +166,13 @@ texec_status_t texec_task_group_create(const texec_task_group_create_info_t* inf
   texec_task_group_t* g = texec_allocate(alloc, sizeof(*g), _Alignof(texec_task_group_t));
   if (!g) return TEXEC_STATUS_OUT_OF_MEMORY;
 
+  const texec_task_group_create_aggregate_info_t* ai = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_AGGREGATE_INFO);
+  const texec_task_group_aggregate_t aggregate = ai ? ai->aggregate : TEXEC_TASK_GROUP_AGGREGATE_NONE;
+
+  const texec_task_group_create_cancel_info_t* ci = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_CANCEL_INFO);
+
   const size_t capacity = (info->capacity ? info->capacity : TASK_GROUP_DEFAULT_CAPACITY);
-  texec_status_t st = task_group_init(g, capacity, alloc);
+  texec_status_t st = task_group_init(g, capacity, aggregate, ci ? ci->token : NULL, alloc);
   if (st != TEXEC_STATUS_OK) {
     texec_free(alloc, g, sizeof(*g), _Alignof(texec_task_group_t));
   } else {
@@ -110,13 +190,21 @@ void texec_task_group_destroy(texec_task_group_t* g) {
     g->handles[i] = NULL;
   }
   g->count = 0;
-  mtx_unlock(&g->mtx);
-  mtx_destroy(&g->mtx);
 
   if (g->handles) {
     free_task_handles(g->alloc, g->handles, g->capacity);
+    g->handles = NULL;
   }
-  texec_free(g->alloc, g, sizeof(*g), _Alignof(texec_task_group_t));
+  mtx_unlock(&g->mtx);
+
+  // The last counted task to finish frees an orphaned group
+  unsigned int s = atomic_load_explicit(&g->state, memory_order_acquire);
+  do {
+    if (task_group_pending(s) == 0) {
+      task_group_free(g);
+      return;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&g->state, &s, s | TASK_GROUP_ORPHANED, memory_order_acq_rel, memory_order_acquire));
 }
 
 texec_status_t texec_task_group_add(texec_task_group_t* g, texec_task_handle_t* h) {
@@ -139,9 +227,20 @@ texec_status_t texec_task_group_add(texec_task_group_t* g, texec_task_handle_t*
   return TEXEC_STATUS_OK;
 }
 
-texec_status_t texec_task_group_wait(texec_task_group_t* g) {
-  if (!g) return TEXEC_STATUS_INVALID_ARGUMENT;
+// Hands `handles` back to the group after a timed wait gave up on them. Waiting closes the group
+// and only one waiter at a time can hold its handles, so the group's array is still detached:
+// putting them back needs no memory and cannot fail.
+static void task_group_restore_handles(texec_task_group_t* g, texec_task_handle_t** handles, size_t count, size_t capacity) {
+  mtx_lock(&g->mtx);
+  assert(g->closed && !g->handles && g->count == 0);
+  g->handles = handles;
+  g->count = count;
+  g->capacity = capacity;
+  mtx_unlock(&g->mtx);
+}
 
+// Waits for the added handles, then for the counted tasks, until `deadline_ns` (UINT64_MAX: none).
+static texec_status_t task_group_wait_until(texec_task_group_t* g, uint64_t deadline_ns) {
   mtx_lock(&g->mtx);
 
   g->closed = true;
@@ -156,8 +255,19 @@ texec_status_t texec_task_group_wait(texec_task_group_t* g) {
 
   mtx_unlock(&g->mtx);
 
+  if (count && deadline_ns != UINT64_MAX) {
+    const uint64_t now = texec_clock_now_ns();
+    if (texec_task_handle_wait_all(handles, count, deadline_ns > now ? deadline_ns - now : 0) != TEXEC_STATUS_OK) {
+      task_group_restore_handles(g, handles, count, capacity);
+      return TEXEC_STATUS_NOT_READY;
+    }
+  }
+
   for (size_t i = 0; i < count; ++i) {
-    texec_task_handle_wait(handles[i]);
+    int result = 0;
+    if (texec_task_handle_result(handles[i], &result) == TEXEC_STATUS_OK) {
+      texec_task_group_record_result(g, result);
+    }
     texec_task_handle_release(handles[i]);
   }
 
@@ -165,5 +275,79 @@ texec_status_t texec_task_group_wait(texec_task_group_t* g) {
     free_task_handles(g->alloc, handles, capacity);
   }
 
+  return task_group_wait_pending(g, deadline_ns) ? TEXEC_STATUS_OK : TEXEC_STATUS_NOT_READY;
+}
+
+texec_status_t texec_task_group_wait(texec_task_group_t* g) {
+  if (!g) return TEXEC_STATUS_INVALID_ARGUMENT;
+  return task_group_wait_until(g, UINT64_MAX);
+}
+
+texec_status_t texec_task_group_wait_for(texec_task_group_t* g, uint64_t timeout_ns) {
+  if (!g) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (timeout_ns == TEXEC_WAIT_FOREVER) return task_group_wait_until(g, UINT64_MAX);
+
+  const uint64_t now = texec_clock_now_ns();
+  return task_group_wait_until(g, timeout_ns < UINT64_MAX - now ? now + timeout_ns : UINT64_MAX - 1);
+}
+
+texec_status_t texec_task_group_result(texec_task_group_t* g, long long* out_result) {
+  if (!g || !out_result) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (g->aggregate == TEXEC_TASK_GROUP_AGGREGATE_NONE) return TEXEC_STATUS_UNSUPPORTED;
+
+  texec_status_t st = texec_task_group_wait(g);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  *out_result = atomic_load_explicit(&g->result, memory_order_relaxed);
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_task_group_enter(texec_task_group_t* g, size_t count) {
+  if (count == 0) return TEXEC_STATUS_OK;
+
+  unsigned int s = atomic_load_explicit(&g->state, memory_order_relaxed);
+  do {
+    if (count > TASK_GROUP_MAX_PENDING - task_group_pending(s)) return TEXEC_STATUS_REJECTED;
+  } while (!atomic_compare_exchange_weak_explicit(&g->state, &s, s + (unsigned int)count * TASK_GROUP_PENDING_ONE, memory_order_relaxed, memory_order_relaxed));
+
   return TEXEC_STATUS_OK;
 }
+
+void texec_task_group_leave(texec_task_group_t* g, size_t count) {
+  if (count == 0) return;
+
+  const unsigned int delta = (unsigned int)count * TASK_GROUP_PENDING_ONE;
+  const unsigned int prev = atomic_fetch_sub_explicit(&g->state, delta, memory_order_acq_rel);
+  assert(task_group_pending(prev) >= count);
+
+  if (task_group_pending(prev) != count) return;
+
+  if (prev & TASK_GROUP_ORPHANED) {
+    task_group_free(g);
+  } else if (prev & TASK_GROUP_WAITERS) {
+    // A woken waiter may free `g` before this runs; the futex wake never dereferences the address.
+    texec_futex_wake_all(&g->state);
+  }
+}
+
+texec_cancel_token_t* texec_task_group_cancel_token(const texec_task_group_t* g) {
+  return g->cancel;
+}
+
+void texec_task_group_record_result(texec_task_group_t* g, int result) {
+  switch (g->aggregate) {
+  case TEXEC_TASK_GROUP_AGGREGATE_FIRST_ERROR:
+    if (result != 0) {
+      long long expected = 0;
+      atomic_compare_exchange_strong_explicit(&g->result, &expected, result, memory_order_relaxed, memory_order_relaxed);
+    }
+    break;
+
+  case TEXEC_TASK_GROUP_AGGREGATE_SUM:
+    atomic_fetch_add_explicit(&g->result, result, memory_order_relaxed);
+    break;
+
+  default:
+    break;
+  }
+}
@@ -1,88 +1,252 @@
 #include "texec/task_handle.h"
 
+#include <assert.h>
+#include <limits.h>
 #include <stdatomic.h>
 #include <stddef.h>
 #include <string.h>
-#include <threads.h>
+
+#include "texec/clock.h"
 
 #include "internal/allocator.h"
+#include "internal/futex.h"
+#include "internal/help.h"
+#include "internal/object_pool.h"
+#include "internal/spin.h"
+#include "internal/task_handle.h"
+
+// `state` holds the completion flag and a waiter bit: the completer only issues a wake-up
+// when somebody announced it is (about to be) parked on the handle.
+#define TASK_HANDLE_DONE    1u
+#define TASK_HANDLE_WAITERS 2u
+
+static const unsigned int TASK_HANDLE_SPIN_COUNT = 64;
 
 struct texec_task_handle {
-  mtx_t mtx;
-  cnd_t cv;
-  const texec_allocator_t* alloc;
+  atomic_uint state;
   atomic_uint refcount;
-  int result;
-  bool done;
+  int result; // written once before TASK_HANDLE_DONE is published
+  texec_status_t status; // likewise; TEXEC_STATUS_OK unless the task was dropped
+  texec_object_pool_t* pool;      // NULL when allocated directly from `alloc`
+  const texec_allocator_t* alloc; // the pool's allocator for pooled handles
+  atomic_uint continuations_lock; // spin lock guarding `continuations`
+  texec_task_handle_continuation_t* continuations; // doubly linked; task_handle_fired once run
+  size_t payload_size; // result storage allocated right after the handle; never pooled
 };
 
-static inline bool task_handle_init(texec_task_handle_t* h, const texec_allocator_t* alloc) {
-  if (!h) return false;
-
-  if (mtx_init(&h->mtx, mtx_plain) != thrd_success) {
-    return false;
-  }
+_Thread_local texec_task_handle_t* texec_task_handle_current = NULL;
 
-  if (cnd_init(&h->cv) != thrd_success) {
-    mtx_destroy(&h->mtx);
-    return false;
-  }
+// Marks a continuation list that has already been run: later additions are refused.
+static texec_task_handle_continuation_t task_handle_fired;
 
+static inline void task_handle_reset(texec_task_handle_t* h, const texec_allocator_t* alloc, texec_object_pool_t* pool) {
+  atomic_init(&h->state, 0u);
   atomic_init(&h->refcount, 1);
-  h->alloc = alloc;
   h->result = 0;
-  h->done = false;
-  return true;
+  h->status = TEXEC_STATUS_OK;
+  h->pool = pool;
+  h->alloc = alloc;
+  atomic_init(&h->continuations_lock, 0u);
+  h->continuations = NULL;
+  h->payload_size = 0;
+}
+
+static inline size_t task_handle_payload_offset(void) {
+  return (sizeof(texec_task_handle_t) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+}
+
+static inline void* task_handle_payload(texec_task_handle_t* h) {
+  return h->payload_size ? (unsigned char*)h + task_handle_payload_offset() : NULL;
 }
 
 static inline void task_handle_free(texec_task_handle_t* h) {
+  if (h->payload_size) {
+    texec_free(h->alloc, h, task_handle_payload_offset() + h->payload_size, _Alignof(max_align_t));
+    return;
+  }
   texec_free(h->alloc, h, sizeof(*h), _Alignof(texec_task_handle_t));
 }
 
-static inline texec_status_t task_handle_unlock_return(texec_task_handle_t* h, texec_status_t st) {
-  mtx_unlock(&h->mtx);
-  return st;
+// Held for a few pointer updates only; waiters wanting a removal on timeout and the completer
+// taking the list are the only contenders.
+static inline void task_handle_lock_continuations(texec_task_handle_t* h) {
+  for (;;) {
+    if (!atomic_exchange_explicit(&h->continuations_lock, 1u, memory_order_acquire)) return;
+    while (atomic_load_explicit(&h->continuations_lock, memory_order_relaxed)) texec_cpu_relax();
+  }
+}
+
+static inline void task_handle_unlock_continuations(texec_task_handle_t* h) {
+  atomic_store_explicit(&h->continuations_lock, 0u, memory_order_release);
+}
+
+static inline bool task_handle_done(unsigned int state) {
+  return (state & TASK_HANDLE_DONE) != 0;
+}
+
+// Turns a relative timeout into a deadline on the texec_clock_now_ns() clock.
+static inline uint64_t task_handle_deadline(uint64_t timeout_ns) {
+  if (timeout_ns == TEXEC_WAIT_FOREVER) return UINT64_MAX;
+  const uint64_t now = texec_clock_now_ns();
+  return timeout_ns < UINT64_MAX - now ? now + timeout_ns : UINT64_MAX;
 }
 
-static inline texec_status_t task_handle_get_result(texec_task_handle_t* h, int* out_result, bool block)
+// Spins briefly, then parks on the state word until the handle is done; a pool worker runs
+// queued tasks meanwhile. Returns false if `deadline_ns` passed first.
+static bool task_handle_wait_done(texec_task_handle_t* h, uint64_t deadline_ns) {
+  unsigned int state = atomic_load_explicit(&h->state, memory_order_acquire);
+
+  for (unsigned int i = 0; i < TASK_HANDLE_SPIN_COUNT && !task_handle_done(state); ++i) {
+    texec_cpu_relax();
+    state = atomic_load_explicit(&h->state, memory_order_acquire);
+  }
+
+  while (!task_handle_done(state)) {
+    if (texec_help_run_one(deadline_ns)) {
+      state = atomic_load_explicit(&h->state, memory_order_acquire);
+      continue;
+    }
+    if (!(state & TASK_HANDLE_WAITERS)) {
+      if (!atomic_compare_exchange_weak_explicit(&h->state, &state, state | TASK_HANDLE_WAITERS,
+                                                 memory_order_acquire, memory_order_acquire)) {
+        continue;
+      }
+      state |= TASK_HANDLE_WAITERS;
+    }
+    // A waiter that times out leaves the bit set; the completer then issues one wake too many
+    if (!texec_help_park(&h->state, state, deadline_ns)) return false;
+    state = atomic_load_explicit(&h->state, memory_order_acquire);
+  }
+  return true;
+}
+
+// `deadline_ns` is 0 for a poll and UINT64_MAX to block until the handle is done.
+static inline texec_status_t task_handle_get_result(texec_task_handle_t* h, int* out_result, uint64_t deadline_ns)
 {
   if (!h || !out_result) return TEXEC_STATUS_INVALID_ARGUMENT;
-  mtx_lock(&h->mtx);
-  while (!h->done) {
-    if (!block) return task_handle_unlock_return(h, TEXEC_STATUS_NOT_READY);
-    cnd_wait(&h->cv, &h->mtx);
+
+  if (!task_handle_done(atomic_load_explicit(&h->state, memory_order_acquire))) {
+    if (deadline_ns == 0 || !task_handle_wait_done(h, deadline_ns)) return TEXEC_STATUS_NOT_READY;
   }
+
   *out_result = h->result;
-  mtx_unlock(&h->mtx);
-  return TEXEC_STATUS_OK;
+  return h->status;
 }
 
 texec_task_handle_t* texec_task_handle_create(const texec_allocator_t* alloc) {
   texec_task_handle_t* h = texec_allocate(alloc, sizeof(*h), _Alignof(texec_task_handle_t));
-  if (!task_handle_init(h, alloc)) {
-    task_handle_free(h);
-    return NULL;
-  }
+  if (!h) return NULL;
+  task_handle_reset(h, alloc, NULL);
+  return h;
+}
+
+texec_task_handle_t* texec_task_handle_create_with_payload(const texec_allocator_t* alloc, size_t payload_size) {
+  if (!payload_size) return texec_task_handle_create(alloc);
+
+  _Static_assert(_Alignof(max_align_t) >= _Alignof(texec_task_handle_t), "payload alignment covers the handle");
+  texec_task_handle_t* h = texec_allocate(alloc, task_handle_payload_offset() + payload_size, _Alignof(max_align_t));
+  if (!h) return NULL;
+  task_handle_reset(h, alloc, NULL);
+  h->payload_size = payload_size;
+  memset(task_handle_payload(h), 0, payload_size);
+  return h;
+}
+
+texec_status_t texec_task_handle_pool_create(const texec_allocator_t* alloc,
+                                             size_t slab_capacity,
+                                             size_t thread_cache_capacity,
+                                             texec_object_pool_t** out_pool) {
+  const texec_object_pool_config_t cfg = {
+    .alloc = alloc,
+    .object_size = sizeof(texec_task_handle_t),
+    .object_align = _Alignof(texec_task_handle_t),
+    .slab_capacity = slab_capacity,
+    .thread_cache_capacity = thread_cache_capacity,
+  };
+  return texec_object_pool_create(&cfg, out_pool);
+}
+
+texec_task_handle_t* texec_task_handle_create_pooled(texec_object_pool_t* pool) {
+  texec_task_handle_t* h = texec_object_pool_acquire(pool);
+  if (!h) return NULL;
+  task_handle_reset(h, texec_object_pool_allocator(pool), pool);
   return h;
 }
 
 void texec_task_handle_destroy(texec_task_handle_t* h) {
   if (!h) return;
-  cnd_destroy(&h->cv);
-  mtx_destroy(&h->mtx);
+  if (h->pool) {
+    texec_object_pool_recycle(h->pool, h);
+    return;
+  }
   task_handle_free(h);
 }
 
+static void task_handle_publish(texec_task_handle_t* h, texec_status_t status, int result) {
+  // Handles are completed exactly once, by whoever consumed their work item.
+  assert(!task_handle_done(atomic_load_explicit(&h->state, memory_order_relaxed)));
+
+  h->result = result;
+  h->status = status;
+  const unsigned int prev = atomic_exchange_explicit(&h->state, TASK_HANDLE_DONE, memory_order_acq_rel);
+  if (prev & TASK_HANDLE_WAITERS) {
+    texec_futex_wake_all(&h->state);
+  }
+
+  // The completer still holds a reference, so `h` outlives the continuations even if a woken
+  // waiter releases it. A continuation may free its node.
+  task_handle_lock_continuations(h);
+  texec_task_handle_continuation_t* c = h->continuations;
+  h->continuations = &task_handle_fired;
+  task_handle_unlock_continuations(h);
+  while (c) {
+    texec_task_handle_continuation_t* next = c->next;
+    c->fire(c);
+    c = next;
+  }
+}
+
 void texec_task_handle_complete(texec_task_handle_t* h, int result) {
   if (!h) return;
+  task_handle_publish(h, TEXEC_STATUS_OK, result);
+}
+
+void texec_task_handle_drop(texec_task_handle_t* h, texec_status_t reason) {
+  if (!h) return;
+  task_handle_publish(h, reason, 0);
+}
 
-  mtx_lock(&h->mtx);
-  if (!h->done) {
-    h->result = result;
-    h->done = true;
-    cnd_broadcast(&h->cv);
+bool texec_task_handle_add_continuation(texec_task_handle_t* h, texec_task_handle_continuation_t* c) {
+  task_handle_lock_continuations(h);
+  texec_task_handle_continuation_t* head = h->continuations;
+  const bool added = head != &task_handle_fired;
+  if (added) {
+    c->prev = NULL;
+    c->next = head;
+    if (head) head->prev = c;
+    h->continuations = c;
   }
-  mtx_unlock(&h->mtx);
+  task_handle_unlock_continuations(h);
+  return added;
+}
+
+bool texec_task_handle_remove_continuation(texec_task_handle_t* h, texec_task_handle_continuation_t* c) {
+  task_handle_lock_continuations(h);
+  const bool removed = h->continuations != &task_handle_fired;
+  if (removed) {
+    if (c->prev) {
+      c->prev->next = c->next;
+    } else {
+      h->continuations = c->next;
+    }
+    if (c->next) c->next->prev = c->prev;
+  }
+  task_handle_unlock_continuations(h);
+  return removed;
+}
+
+const texec_allocator_t* texec_task_handle_allocator(const texec_task_handle_t* h) {
+  return h->alloc;
 }
 
 texec_status_t texec_task_handle_retain(texec_task_handle_t* h) {
@@ -122,17 +286,154 @@ void texec_task_handle_release(texec_task_handle_t* h) {
 }
 
 texec_status_t texec_task_handle_result(texec_task_handle_t* h, int* out_result) {
-  return task_handle_get_result(h, out_result, true);
+  return task_handle_get_result(h, out_result, UINT64_MAX);
 }
 
 texec_status_t texec_task_handle_try_result(texec_task_handle_t* h, int* out_result) {
-  return task_handle_get_result(h, out_result, false);
+  return task_handle_get_result(h, out_result, 0);
+}
+
+texec_status_t texec_task_handle_result_for(texec_task_handle_t* h, uint64_t timeout_ns, int* out_result) {
+  return task_handle_get_result(h, out_result, timeout_ns ? task_handle_deadline(timeout_ns) : 0);
+}
+
+texec_status_t texec_task_handle_payload(texec_task_handle_t* h, const void** out_payload, size_t* out_size) {
+  if (!h || !out_payload || !out_size) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (!task_handle_done(atomic_load_explicit(&h->state, memory_order_acquire))) return TEXEC_STATUS_NOT_READY;
+
+  *out_payload = task_handle_payload(h);
+  *out_size = h->payload_size;
+  return h->status;
+}
+
+void* texec_task_result_payload(size_t* out_size) {
+  texec_task_handle_t* h = texec_task_handle_current;
+  if (out_size) *out_size = h ? h->payload_size : 0;
+  return h ? task_handle_payload(h) : NULL;
 }
 
 bool texec_task_handle_is_done(texec_task_handle_t* h) {
   if (!h) return false;
-  mtx_lock(&h->mtx);
-  const bool done = h->done;
-  mtx_unlock(&h->mtx);
+  return task_handle_done(atomic_load_explicit(&h->state, memory_order_acquire));
+}
+
+// Shared notification of texec_task_handle_wait_any/_all: one continuation per watched handle
+// counts `remaining` down and wakes the waiter when it reaches `target`. The waiter takes its
+// continuations back from the handles still pending when it returns; the set is refcounted so
+// that one already being fired by a completer can still reach it, and freed by the last of the
+// waiter and those continuations.
+typedef struct task_handle_wait_set task_handle_wait_set_t;
+
+typedef struct task_handle_wait_node {
+  texec_task_handle_continuation_t continuation; // first member: fire() casts back
+  task_handle_wait_set_t* set;
+  bool registered; // added to its handle, which was not done yet
+} task_handle_wait_node_t;
+
+struct task_handle_wait_set {
+  atomic_uint remaining; // handles not done yet; futex word the waiter parks on
+  atomic_uint refcount;
+  unsigned int target;   // count - 1 for wait_any, 0 for wait_all
+  const texec_allocator_t* alloc;
+  size_t count;
+  task_handle_wait_node_t nodes[];
+};
+
+static inline size_t task_handle_wait_set_size(size_t count) {
+  return sizeof(task_handle_wait_set_t) + count * sizeof(task_handle_wait_node_t);
+}
+
+static void task_handle_wait_set_release(task_handle_wait_set_t* set, unsigned int count) {
+  if (atomic_fetch_sub_explicit(&set->refcount, count, memory_order_acq_rel) == count) {
+    texec_free(set->alloc, set, task_handle_wait_set_size(set->count), _Alignof(task_handle_wait_set_t));
+  }
+}
+
+static void task_handle_wait_node_fire(texec_task_handle_continuation_t* c) {
+  task_handle_wait_set_t* set = ((task_handle_wait_node_t*)c)->set;
+  if (atomic_fetch_sub_explicit(&set->remaining, 1u, memory_order_acq_rel) - 1u == set->target) {
+    texec_futex_wake_one(&set->remaining);
+  }
+  task_handle_wait_set_release(set, 1u);
+}
+
+static inline bool task_handle_validate_array(texec_task_handle_t* const* handles, size_t count) {
+  if (count == 0 || !handles || count >= UINT_MAX) return false;
+  for (size_t i = 0; i < count; ++i) {
+    if (!handles[i]) return false;
+  }
+  return true;
+}
+
+static size_t task_handle_count_done(texec_task_handle_t* const* handles, size_t count, size_t* out_first) {
+  size_t done = 0;
+  for (size_t i = count; i-- > 0;) {
+    if (texec_task_handle_is_done(handles[i])) {
+      *out_first = i;
+      ++done;
+    }
+  }
   return done;
 }
+
+// Waits until at least `count - target` of `handles` are done.
+static texec_status_t task_handle_wait_many(texec_task_handle_t* const* handles, size_t count, unsigned int target, uint64_t timeout_ns) {
+  size_t first = 0;
+  if (count - task_handle_count_done(handles, count, &first) <= target) return TEXEC_STATUS_OK;
+  if (timeout_ns == 0) return TEXEC_STATUS_NOT_READY;
+
+  const uint64_t deadline_ns = task_handle_deadline(timeout_ns);
+  const texec_allocator_t* alloc = texec_task_handle_allocator(handles[0]);
+  task_handle_wait_set_t* set = texec_allocate(alloc, task_handle_wait_set_size(count), _Alignof(task_handle_wait_set_t));
+  if (!set) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  atomic_init(&set->remaining, (unsigned int)count);
+  atomic_init(&set->refcount, (unsigned int)count + 1u); // the waiter's, plus one per node
+  set->target = target;
+  set->alloc = alloc;
+  set->count = count;
+
+  // Handles found done while registering count down right here
+  unsigned int done = 0;
+  for (size_t i = 0; i < count; ++i) {
+    task_handle_wait_node_t* node = &set->nodes[i];
+    node->continuation.fire = task_handle_wait_node_fire;
+    node->set = set;
+    node->registered = texec_task_handle_add_continuation(handles[i], &node->continuation);
+    if (!node->registered) ++done;
+  }
+  unsigned int remaining = atomic_fetch_sub_explicit(&set->remaining, done, memory_order_acq_rel) - done;
+
+  bool timed_out = false;
+  while (remaining > target && !timed_out) {
+    if (!texec_help_run_one(deadline_ns)) timed_out = !texec_help_park(&set->remaining, remaining, deadline_ns);
+    remaining = atomic_load_explicit(&set->remaining, memory_order_acquire);
+  }
+
+  // Without this, a wait that times out or returns early would stay registered, and allocated,
+  // for as long as the other handles run
+  unsigned int removed = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (set->nodes[i].registered && texec_task_handle_remove_continuation(handles[i], &set->nodes[i].continuation)) ++removed;
+  }
+
+  task_handle_wait_set_release(set, done + removed + 1u);
+  return remaining > target ? TEXEC_STATUS_NOT_READY : TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_task_handle_wait_any(texec_task_handle_t* const* handles, size_t count, uint64_t timeout_ns, size_t* out_index) {
+  if (!out_index || !task_handle_validate_array(handles, count)) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  const texec_status_t st = task_handle_wait_many(handles, count, (unsigned int)count - 1u, timeout_ns);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  // Completions are published before the continuations run, so one of them is visible here
+  task_handle_count_done(handles, count, out_index);
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_task_handle_wait_all(texec_task_handle_t* const* handles, size_t count, uint64_t timeout_ns) {
+  if (count == 0) return TEXEC_STATUS_OK;
+  if (!task_handle_validate_array(handles, count)) return TEXEC_STATUS_INVALID_ARGUMENT;
+  return task_handle_wait_many(handles, count, 0u, timeout_ns);
+}
@@ -1,22 +1,138 @@
 #include "internal/executor.h"
 
 #include <assert.h>
+#include <stdatomic.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <threads.h>
 
+#include "texec/clock.h"
 #include "texec/queue.h"
 #include "texec/task_group.h"
+#include "internal/deadline_heap.h"
+#include "internal/event_count.h"
+#include "internal/help.h"
+#include "internal/placement.h"
+#include "internal/spin.h"
 #include "internal/task_handle.h"
+#include "internal/topology.h"
+#include "internal/worker_metrics.h"
+
+// Upper bound on work items a worker dequeues at once; the actual batch adapts to queue depth
+#define TP_WORKER_MAX_BATCH 8
+
+// Work items submit_many builds before handing them to the queue in one push
+#define TP_SUBMIT_BATCH 64
+
+// Tasks a worker runs in a row from its LIFO slot before the next one goes to the back of the
+// run queue, so that tasks which keep handing work to each other cannot starve queued ones
+#define TP_LIFO_SLOT_MAX_STREAK 3
+
+// Pops between a worker's checks of whether an elastic pool should grow
+#define TP_GROW_CHECK_INTERVAL 16
+
+// One run queue per texec_submit_priority_t
+typedef enum tp_level {
+  TP_LEVEL_HIGH,
+  TP_LEVEL_NORMAL,
+  TP_LEVEL_LOW,
+  TP_LEVEL_COUNT
+} tp_level_t;
+
+// Turn of the deadline heap in TP_SCHEDULE, next to those of the run queue levels
+#define TP_TURN_DEADLINE ((unsigned int)TP_LEVEL_COUNT)
+
+// Source each worker tries first on successive pops: the deadline heap gets every other turn and
+// HIGH, NORMAL and LOW share the rest 4:2:1 while all of them have work, so neither deadline nor
+// HIGH work can starve the rest. A source with nothing queued passes its turn on.
+static const unsigned int TP_SCHEDULE[] = {
+  TP_TURN_DEADLINE, TP_LEVEL_HIGH, TP_TURN_DEADLINE, TP_LEVEL_NORMAL, TP_TURN_DEADLINE, TP_LEVEL_HIGH, TP_TURN_DEADLINE,
+  TP_LEVEL_LOW,     TP_TURN_DEADLINE, TP_LEVEL_HIGH, TP_TURN_DEADLINE, TP_LEVEL_NORMAL, TP_TURN_DEADLINE, TP_LEVEL_HIGH,
+};
+#define TP_SCHEDULE_LENGTH (sizeof(TP_SCHEDULE) / sizeof(TP_SCHEDULE[0]))
+
+struct thread_pool_executor;
+
+// Lifecycle of a worker slot; elastic pools start and retire workers while running
+typedef enum tp_worker_state {
+  TP_WORKER_EMPTY,   // no thread
+  TP_WORKER_RUNNING,
+  TP_WORKER_RETIRED, // thread exited on idle timeout and still has to be joined
+} tp_worker_state_t;
+
+typedef struct tp_worker {
+  texec_worker_counters_t counters;
+  struct thread_pool_executor* ex;
+  tp_worker_state_t state; // guarded by the executor's mtx
+  size_t node;             // run queues served first
+  const unsigned int* cpus; // CPUs the worker is restricted to, from the executor's placement
+  size_t cpu_count;
+
+  // Task submitted last by a task running on this worker, run next on the same thread while
+  // its data is still in cache. Idle workers take it if it waits for long; `lifo_level`, the
+  // level of the task the worker put there last, is only touched by the worker's own thread.
+  _Atomic(texec_work_item_t*) lifo;
+  tp_level_t lifo_level;
+
+  // Popped batch being run, which a task blocked in a wait helps drain; worker's thread only
+  const uintptr_t* batch;
+  size_t batch_next;
+  size_t batch_count;
+  size_t cursor; // position in TP_SCHEDULE
+  size_t pops_until_grow_check;
+} tp_worker_t;
+
+// Run queues of one NUMA node; a pool without numa_queues has a single node
+typedef struct tp_node {
+  texec_queue_t* queues[TP_LEVEL_COUNT];
+} tp_node_t;
 
 typedef struct thread_pool_executor {
   texec_executor_t base;
   mtx_t mtx;
-  texec_queue_t* q;
+  tp_node_t* nodes;
+  size_t node_count;
+  bool numa_queues;
+  texec_placement_t placement;
+  tp_worker_t* workers;
   thrd_t* threads;
-  size_t thread_count;
+  size_t thread_count; // worker slots; the maximum number of live workers
   texec_backpressure_policy_t backpressure;
+  texec_event_count_t work_available; // idle workers park here
+
+  // Tasks in the run queues and the deadline heap together, bounded by queue_capacity. Submitters
+  // reserve room here before they enqueue and workers give it back as they dequeue.
+  size_t queue_capacity;
+  atomic_size_t admitted_count;
+  texec_event_count_t space_available; // BLOCK submitters wait here while the queues are full
+  uint32_t spin_count;
+  uint32_t yield_count;
+  atomic_size_t spinning_count; // workers polling for work before they park
+
+  // Elastic sizing; a fixed pool has min_thread_count == thread_count and never grows or retires
+  size_t min_thread_count;
+  uint64_t idle_timeout_ns;
+  size_t grow_queue_depth;
+  uint64_t grow_sojourn_ns;
+  atomic_size_t live_count; // written under mtx
+  atomic_size_t idle_count;
+  atomic_uint_least64_t last_dequeue_ns; // elastic pools only; stamped every TP_GROW_CHECK_INTERVAL pops
+
+  // Tasks with a deadline, served earliest-deadline-first on the heap's turns in TP_SCHEDULE
+  mtx_t edf_mtx;
+  texec_deadline_heap_t edf;
+  bool edf_closed;
+  atomic_size_t edf_count; // mirrors edf.count so workers can skip the lock when it is empty
+  texec_deadline_policy_t deadline_policy;
+  atomic_uint_least64_t expired_count;
+
+  // Updated by submitters on the slow path only
+  atomic_uint_least64_t rejected_count;
+  atomic_uint_least64_t caller_runs_count;
 } thread_pool_executor_t;
 
+static _Thread_local tp_worker_t* tp_current_worker = NULL;
+
 static inline bool tp_is_thread_pool(const texec_executor_t* ex) {
   return ex && ex->kind == TEXEC_EXECUTOR_KIND_THREAD_POOL;
 }
@@ -35,6 +151,12 @@ static inline const thread_pool_executor_t* tp_from_const_base(const texec_execu
   return (const thread_pool_executor_t*)ex;
 }
 
+// The calling thread's worker if it belongs to `ex`, NULL otherwise.
+static inline tp_worker_t* tp_local_worker(thread_pool_executor_t* ex) {
+  tp_worker_t* w = tp_current_worker;
+  return (w && w->ex == ex) ? w : NULL;
+}
+
 static texec_executor_state_t tp_get_state(thread_pool_executor_t* ex) {
   mtx_lock(&ex->mtx);
   const texec_executor_state_t state = ex->base.state;
@@ -47,104 +169,800 @@ static void tp_free(thread_pool_executor_t* ex) {
 }
 
 static texec_status_t tp_destroy_unchecked(thread_pool_executor_t* ex) {  
-  if (ex->q) {
-    texec_status_t st = texec_queue_destroy(ex->q);
-    if (st != TEXEC_STATUS_OK) return st;
+  for (size_t node = 0; ex->nodes && node < ex->node_count; ++node) {
+    for (size_t level = 0; level < TP_LEVEL_COUNT; ++level) {
+      if (!ex->nodes[node].queues[level]) continue;
+      texec_status_t st = texec_queue_destroy(ex->nodes[node].queues[level]);
+      if (st != TEXEC_STATUS_OK) return st;
+      ex->nodes[node].queues[level] = NULL;
+    }
+  }
+
+  if (ex->nodes) {
+    texec_free(ex->base.alloc, ex->nodes, ex->node_count * sizeof(tp_node_t), _Alignof(tp_node_t));
   }
+  texec_placement_destroy(&ex->placement);
+
+  texec_deadline_heap_destroy(&ex->edf);
+  mtx_destroy(&ex->edf_mtx);
 
   if (ex->threads) {
     texec_free(ex->base.alloc, ex->threads, ex->thread_count * sizeof(thrd_t), _Alignof(thrd_t));
   }
+
+  if (ex->workers) {
+    texec_free(ex->base.alloc, ex->workers, ex->thread_count * sizeof(tp_worker_t), _Alignof(tp_worker_t));
+  }
   
   mtx_destroy(&ex->mtx);
+
+  texec_executor_release_pools(&ex->base);
   
   tp_free(ex);
 
   return TEXEC_STATUS_OK;
 }
 
+static void tp_close_queues(thread_pool_executor_t* ex) {
+  for (size_t node = 0; node < ex->node_count; ++node) {
+    for (size_t level = 0; level < TP_LEVEL_COUNT; ++level) {
+      texec_queue_close(ex->nodes[node].queues[level]);
+    }
+  }
+}
+
+static inline bool tp_is_elastic(const thread_pool_executor_t* ex) {
+  return ex->min_thread_count < ex->thread_count;
+}
+
+// Tasks waiting in the run queues and the deadline heap, counting those a submitter is about to push.
+static size_t tp_queue_depth(const thread_pool_executor_t* ex) {
+  return atomic_load_explicit(&ex->admitted_count, memory_order_seq_cst);
+}
+
+static int tp_worker_main(void* arg);
+
+// Starts a worker in a free slot, joining the thread a retired worker left there.
+// Caller holds ex->mtx.
+static bool tp_spawn_worker_locked(thread_pool_executor_t* ex) {
+  const size_t live = atomic_load_explicit(&ex->live_count, memory_order_relaxed);
+  if (ex->base.state != TEXEC_EXECUTOR_STATE_RUNNING || live == ex->thread_count) return false;
+
+  size_t i = 0;
+  while (ex->workers[i].state == TP_WORKER_RUNNING) ++i;
+
+  tp_worker_t* w = &ex->workers[i];
+  if (w->state == TP_WORKER_RETIRED) {
+    thrd_join(ex->threads[i], NULL);
+    w->state = TP_WORKER_EMPTY;
+  }
+
+  if (thrd_create(&ex->threads[i], &tp_worker_main, w) != thrd_success) return false;
+
+  w->state = TP_WORKER_RUNNING;
+  atomic_store_explicit(&ex->live_count, live + 1, memory_order_relaxed);
+  return true;
+}
+
+// Adds a worker when tasks are piling up: the queue is `grow_queue_depth` deep beyond what the
+// idle workers (possibly still waking up) will take, or nobody is idle and queued tasks have
+// waited `grow_sojourn_ns` since the last dequeue. Checked by submitters that find no idle worker
+// and by workers every TP_GROW_CHECK_INTERVAL pops, right after the fence of the submit's wake-up
+// or the seq_cst pop, so the loads here need no fence of their own.
+static void tp_maybe_grow(thread_pool_executor_t* ex) {
+  if (atomic_load_explicit(&ex->live_count, memory_order_relaxed) == ex->thread_count) return;
+
+  const size_t depth = tp_queue_depth(ex);
+  if (depth == 0) return;
+
+  const size_t idle = atomic_load_explicit(&ex->idle_count, memory_order_relaxed);
+  bool grow = depth >= ex->grow_queue_depth + idle;
+  if (!grow && idle == 0 && ex->grow_sojourn_ns) {
+    const uint64_t now = texec_clock_now_ns();
+    const uint64_t last = atomic_load_explicit(&ex->last_dequeue_ns, memory_order_relaxed);
+    grow = now > last && now - last >= ex->grow_sojourn_ns;
+  }
+  if (!grow) return;
+
+  mtx_lock(&ex->mtx);
+  tp_spawn_worker_locked(ex);
+  mtx_unlock(&ex->mtx);
+}
+
+// Makes sure a worker is looking for `count` new tasks, and grows an elastic pool if none is idle.
+// At most one sleeper is woken per burst, and none while a worker is still spinning: whichever
+// worker takes the first task wakes the next sleeper if work is left over.
+static inline void tp_notify_workers(thread_pool_executor_t* ex, size_t count) {
+  if (count == 0) return;
+
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&ex->spinning_count, memory_order_relaxed) == 0) {
+    texec_event_count_notify_one(&ex->work_available);
+  }
+  if (tp_is_elastic(ex) && atomic_load_explicit(&ex->idle_count, memory_order_relaxed) == 0) {
+    tp_maybe_grow(ex);
+  }
+}
+
+// Called by a worker that just took work: hands the wake-up on to another sleeper if more is queued.
+static inline void tp_wake_next(thread_pool_executor_t* ex) {
+  if (atomic_load_explicit(&ex->spinning_count, memory_order_relaxed) == 0 &&
+      texec_event_count_has_waiters(&ex->work_available) && tp_queue_depth(ex) != 0) {
+    texec_event_count_notify_one(&ex->work_available);
+  }
+}
+
+// Retires the calling worker after an idle timeout unless that would leave fewer than
+// `min_thread_count` workers or work has arrived meanwhile.
+static bool tp_try_retire(thread_pool_executor_t* ex, tp_worker_t* w) {
+  bool retired = false;
+
+  mtx_lock(&ex->mtx);
+  const size_t live = atomic_load_explicit(&ex->live_count, memory_order_relaxed);
+  if (ex->base.state == TEXEC_EXECUTOR_STATE_RUNNING && live > ex->min_thread_count && tp_queue_depth(ex) == 0) {
+    w->state = TP_WORKER_RETIRED;
+    atomic_store_explicit(&ex->live_count, live - 1, memory_order_relaxed);
+    retired = true;
+  }
+  mtx_unlock(&ex->mtx);
+
+  return retired;
+}
+
+// Lets elastic pools keep growing while a backlog remains after submits have stopped. Only every
+// TP_GROW_CHECK_INTERVAL pops of `w`, so the last dequeue time the sojourn trigger goes by may be
+// that many pops old.
+static inline void tp_note_dequeue(thread_pool_executor_t* ex, tp_worker_t* w) {
+  if (!tp_is_elastic(ex) || --w->pops_until_grow_check != 0) return;
+
+  w->pops_until_grow_check = TP_GROW_CHECK_INTERVAL;
+  atomic_store_explicit(&ex->last_dequeue_ns, texec_clock_now_ns(), memory_order_relaxed);
+  tp_maybe_grow(ex);
+}
+
+// Parks until notified. Workers above the minimum give up after `idle_timeout_ns`, returning false.
+static bool tp_park(thread_pool_executor_t* ex, unsigned int key) {
+  if (!tp_is_elastic(ex) || atomic_load_explicit(&ex->live_count, memory_order_relaxed) <= ex->min_thread_count) {
+    texec_event_count_wait(&ex->work_available, key);
+    return true;
+  }
+  return texec_event_count_wait_until(&ex->work_available, key, texec_clock_now_ns() + ex->idle_timeout_ns);
+}
+
+// Reserves room for up to `count` tasks under queue_capacity. Returns how many fit.
+static size_t tp_try_admit(thread_pool_executor_t* ex, size_t count) {
+  size_t admitted = atomic_load_explicit(&ex->admitted_count, memory_order_relaxed);
+  size_t n;
+  do {
+    if (admitted >= ex->queue_capacity) return 0;
+    n = ex->queue_capacity - admitted < count ? ex->queue_capacity - admitted : count;
+  } while (!atomic_compare_exchange_weak_explicit(&ex->admitted_count, &admitted, admitted + n, memory_order_seq_cst, memory_order_relaxed));
+  return n;
+}
+
+// Like tp_try_admit, but waits for room while the queues are full. Returns TEXEC_STATUS_CLOSED,
+// with nothing reserved, if the executor closes first.
+static texec_status_t tp_admit(thread_pool_executor_t* ex, size_t count, size_t* out_admitted) {
+  for (;;) {
+    const unsigned int key = texec_event_count_prepare_wait(&ex->space_available);
+    *out_admitted = tp_try_admit(ex, count);
+    if (*out_admitted != 0 || tp_get_state(ex) != TEXEC_EXECUTOR_STATE_RUNNING) {
+      texec_event_count_cancel_wait(&ex->space_available);
+      return *out_admitted != 0 ? TEXEC_STATUS_OK : TEXEC_STATUS_CLOSED;
+    }
+    texec_event_count_wait(&ex->space_available, key);
+  }
+}
+
+// Gives back the room of `count` tasks that left the queues, or never made it in.
+static void tp_release_admitted(thread_pool_executor_t* ex, size_t count) {
+  atomic_fetch_sub_explicit(&ex->admitted_count, count, memory_order_seq_cst);
+  texec_event_count_notify_all(&ex->space_available);
+}
+
+// Moves `w` on to the next turn in TP_SCHEDULE and returns the source it names.
+static inline unsigned int tp_next_turn(tp_worker_t* w) {
+  const unsigned int turn = TP_SCHEDULE[w->cursor];
+  w->cursor = (w->cursor + 1) % TP_SCHEDULE_LENGTH;
+  return turn;
+}
+
+// Level to pop from first on `turn`: its own, or HIGH when the turn is the deadline heap's.
+static inline tp_level_t tp_turn_level(unsigned int turn) {
+  return turn == TP_TURN_DEADLINE ? TP_LEVEL_HIGH : (tp_level_t)turn;
+}
+
+// Pops up to `max_count` items from level `first` on `home`, falling back to its other levels in
+// priority order and then to the other nodes. Returns TEXEC_STATUS_REJECTED if all queues are
+// empty, TEXEC_STATUS_CLOSED once all are closed and drained.
+static texec_status_t tp_try_pop_batch(thread_pool_executor_t* ex, size_t home, tp_level_t first, uintptr_t* out_items, size_t max_count, size_t* out_popped) {
+  texec_status_t st = texec_queue_try_pop_many(ex->nodes[home].queues[first], out_items, max_count, out_popped);
+  if (st == TEXEC_STATUS_OK) {
+    tp_release_admitted(ex, *out_popped);
+    return st;
+  }
+
+  size_t closed = (st == TEXEC_STATUS_CLOSED);
+  for (size_t i = 0; i < ex->node_count; ++i) {
+    const size_t node = (home + i) % ex->node_count;
+    for (size_t level = 0; level < TP_LEVEL_COUNT; ++level) {
+      if (node == home && level == (size_t)first) continue;
+      st = texec_queue_try_pop_many(ex->nodes[node].queues[level], out_items, max_count, out_popped);
+      if (st == TEXEC_STATUS_OK) {
+        tp_release_admitted(ex, *out_popped);
+        return st;
+      }
+      closed += (st == TEXEC_STATUS_CLOSED);
+    }
+  }
+
+  return (closed == ex->node_count * TP_LEVEL_COUNT) ? TEXEC_STATUS_CLOSED : TEXEC_STATUS_REJECTED;
+}
+
+// Pops the queued task with the earliest deadline, if any.
+static bool tp_try_pop_deadline(thread_pool_executor_t* ex, uint64_t* out_deadline_ns, texec_work_item_t** out_wi) {
+  if (atomic_load_explicit(&ex->edf_count, memory_order_seq_cst) == 0) return false;
+
+  uintptr_t item = 0;
+
+  mtx_lock(&ex->edf_mtx);
+  const bool found = texec_deadline_heap_pop(&ex->edf, out_deadline_ns, &item);
+  if (found) atomic_store_explicit(&ex->edf_count, ex->edf.count, memory_order_seq_cst);
+  mtx_unlock(&ex->edf_mtx);
+
+  if (found) tp_release_admitted(ex, 1);
+
+  *out_wi = (texec_work_item_t*)item;
+  return found;
+}
+
+// Returns false if the task was dropped instead of run.
+static bool tp_consume_deadline_item(thread_pool_executor_t* ex, texec_work_item_t* wi, uint64_t deadline_ns) {
+  if (ex->deadline_policy == TEXEC_DEADLINE_POLICY_DROP_EXPIRED && texec_clock_now_ns() > deadline_ns) {
+    atomic_fetch_add_explicit(&ex->expired_count, 1, memory_order_relaxed);
+    texec_executor_drop_work_item(&ex->base, wi, TEXEC_STATUS_EXPIRED);
+    return false;
+  }
+  texec_executor_consume_work_item(&ex->base, wi);
+  return true;
+}
+
+// Runs the queued task with the earliest deadline, or drops it if it expired. Returns false if the
+// heap was empty.
+static bool tp_run_deadline_item(thread_pool_executor_t* ex, tp_worker_t* w) {
+  uint64_t deadline_ns = 0;
+  texec_work_item_t* wi = NULL;
+  if (!tp_try_pop_deadline(ex, &deadline_ns, &wi)) return false;
+
+  tp_note_dequeue(ex, w);
+  tp_wake_next(ex);
+  if (tp_consume_deadline_item(ex, wi, deadline_ns)) {
+    texec_worker_counter_add(&w->counters.tasks_executed, 1);
+  }
+  return true;
+}
+
+// Takes the task `w` left in its LIFO slot, if nobody took it first.
+static inline texec_work_item_t* tp_lifo_take(tp_worker_t* w) {
+  return atomic_exchange_explicit(&w->lifo, NULL, memory_order_acq_rel);
+}
+
+// Whether another worker than `w` has a task in its LIFO slot.
+static bool tp_lifo_pending(thread_pool_executor_t* ex, const tp_worker_t* w) {
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    if (&ex->workers[i] != w && atomic_load_explicit(&ex->workers[i].lifo, memory_order_seq_cst)) return true;
+  }
+  return false;
+}
+
+// Takes a task another worker left in its LIFO slot; called once the queues are empty, so a
+// submitter that keeps running does not hold its follow-up back from idle workers.
+static texec_work_item_t* tp_lifo_steal(thread_pool_executor_t* ex, const tp_worker_t* w) {
+  const size_t self = (size_t)(w - ex->workers);
+  for (size_t i = 1; i < ex->thread_count; ++i) {
+    tp_worker_t* victim = &ex->workers[(self + i) % ex->thread_count];
+    if (!atomic_load_explicit(&victim->lifo, memory_order_relaxed)) continue;
+    texec_work_item_t* wi = tp_lifo_take(victim);
+    if (wi) return wi;
+  }
+  return NULL;
+}
+
+// Pushes `wi` on the run queue of `level` on `node` if there is room under queue_capacity.
+static bool tp_try_push_admitted(thread_pool_executor_t* ex, size_t node, tp_level_t level, texec_work_item_t* wi) {
+  if (tp_try_admit(ex, 1) == 0) return false;
+  if (texec_queue_try_push_ptr(ex->nodes[node].queues[level], wi) == TEXEC_STATUS_OK) return true;
+  tp_release_admitted(ex, 1);
+  return false;
+}
+
+// Moves an already accepted task out of the worker's LIFO slot to the back of its run queue.
+// It cannot be rejected any more, so if the queue is full or closed it runs right here, from the
+// worker loop.
+static void tp_spill_work_item(thread_pool_executor_t* ex, size_t node, tp_level_t level, texec_work_item_t* wi) {
+  if (tp_try_push_admitted(ex, node, level, wi)) {
+    tp_notify_workers(ex, 1);
+    return;
+  }
+  texec_executor_consume_work_item(&ex->base, wi);
+}
+
+// Runs what the task just consumed left in the LIFO slot, and what those leave in turn, up to
+// TP_LIFO_SLOT_MAX_STREAK in a row. Returns the number of tasks run; the slot is empty after.
+static size_t tp_run_lifo_slot(thread_pool_executor_t* ex, tp_worker_t* w) {
+  size_t ran = 0;
+  size_t streak = 0;
+  texec_work_item_t* wi;
+  while ((wi = tp_lifo_take(w)) != NULL) {
+    if (streak == TP_LIFO_SLOT_MAX_STREAK) {
+      streak = 0;
+      tp_spill_work_item(ex, w->node, w->lifo_level, wi);
+      continue; // running the spilled task inline may have refilled the slot
+    }
+
+    texec_executor_consume_work_item(&ex->base, wi);
+    ++streak;
+    ++ran;
+  }
+  return ran;
+}
+
+// Polls for work for the configured spin and yield budget before the caller parks. Returns
+// TEXEC_STATUS_REJECTED once the budget is used up, TEXEC_STATUS_NOT_READY if a deadline task
+// or a task in another worker's LIFO slot showed up, and otherwise the status of the pop that
+// ended the spin.
+static texec_status_t tp_spin_for_work(thread_pool_executor_t* ex, tp_worker_t* w, tp_level_t first, uintptr_t* out_items, size_t max_count, size_t* out_popped) {
+  atomic_fetch_add_explicit(&ex->spinning_count, 1, memory_order_seq_cst);
+
+  texec_status_t st = TEXEC_STATUS_REJECTED;
+  const uint64_t budget = (uint64_t)ex->spin_count + ex->yield_count;
+  for (uint64_t i = 0; i < budget && st == TEXEC_STATUS_REJECTED; ++i) {
+    if (i < ex->spin_count) {
+      texec_cpu_relax();
+    } else {
+      thrd_yield();
+    }
+
+    if (atomic_load_explicit(&ex->edf_count, memory_order_seq_cst) != 0 || tp_lifo_pending(ex, w)) {
+      st = TEXEC_STATUS_NOT_READY;
+    } else {
+      st = tp_try_pop_batch(ex, w->node, first, out_items, max_count, out_popped);
+    }
+  }
+
+  atomic_fetch_sub_explicit(&ex->spinning_count, 1, memory_order_seq_cst);
+  return st;
+}
+
+// Runs one task while a task of this worker is blocked in a wait: what the worker already holds
+// (its LIFO slot, then the rest of its batch) first, else a deadline or queued task as the
+// schedule has it, else one from another worker's LIFO slot.
+static bool tp_help_run_one(void* arg) {
+  tp_worker_t* w = (tp_worker_t*)arg;
+  thread_pool_executor_t* ex = w->ex;
+
+  texec_work_item_t* wi = tp_lifo_take(w);
+  if (!wi && w->batch_next < w->batch_count) {
+    wi = (texec_work_item_t*)w->batch[w->batch_next++];
+  }
+
+  if (!wi) {
+    const unsigned int turn = tp_next_turn(w);
+    if (turn == TP_TURN_DEADLINE && tp_run_deadline_item(ex, w)) return true;
+
+    uintptr_t item = 0;
+    size_t n = 0;
+    if (tp_try_pop_batch(ex, w->node, tp_turn_level(turn), &item, 1, &n) == TEXEC_STATUS_OK) {
+      tp_note_dequeue(ex, w);
+      tp_wake_next(ex);
+      wi = (texec_work_item_t*)item;
+    } else if (turn != TP_TURN_DEADLINE && tp_run_deadline_item(ex, w)) {
+      return true;
+    } else {
+      wi = tp_lifo_steal(ex, w);
+      if (!wi) return false;
+    }
+  }
+
+  texec_executor_consume_work_item(&ex->base, wi);
+  texec_worker_counter_add(&w->counters.tasks_executed, 1);
+  return true;
+}
+
 static int tp_worker_main(void* arg) {
-  thread_pool_executor_t* ex = (thread_pool_executor_t*)arg;
+  tp_worker_t* w = (tp_worker_t*)arg;
+  thread_pool_executor_t* ex = w->ex;
+
+  uintptr_t batch[TP_WORKER_MAX_BATCH];
+  size_t batch_size = 1;
+
+  w->batch = batch;
+  w->batch_next = 0;
+  w->batch_count = 0;
+  w->cursor = 0;
+  w->pops_until_grow_check = 1; // the first pop stamps the dequeue time
+  tp_current_worker = w;
+
+  const texec_helper_t helper = {tp_help_run_one, w};
+  texec_help_install(&helper);
+
+  if (w->cpu_count) {
+    texec_topology_pin_current_thread(w->cpus, w->cpu_count); // best effort
+  }
+
+  // Time between start-up (or an earlier worker's retirement) and now counts as idle
+  texec_worker_counters_transition(&w->counters, false);
 
   for (;;) {
-    texec_work_item_t* wi = NULL;
-    texec_status_t st = texec_queue_pop_ptr(ex->q, &wi);
+    const unsigned int turn = tp_next_turn(w);
+    const tp_level_t first = tp_turn_level(turn);
+    size_t n = 0;
+    texec_status_t st = TEXEC_STATUS_REJECTED;
+    if (turn != TP_TURN_DEADLINE) {
+      st = tp_try_pop_batch(ex, w->node, first, batch, batch_size, &n);
+    }
 
-    if (st == TEXEC_STATUS_OK) {
+    // The heap on its own turn, and on the others whenever the run queues are empty
+    if (st != TEXEC_STATUS_OK && tp_run_deadline_item(ex, w)) {
+      texec_worker_counter_add(&w->counters.tasks_executed, tp_run_lifo_slot(ex, w));
+      continue;
+    }
+
+    if (turn == TP_TURN_DEADLINE) {
+      st = tp_try_pop_batch(ex, w->node, first, batch, batch_size, &n);
+    }
+
+    texec_work_item_t* wi = NULL;
+    if (st == TEXEC_STATUS_REJECTED && (wi = tp_lifo_steal(ex, w)) != NULL) {
       texec_executor_consume_work_item(&ex->base, wi);
+      texec_worker_counter_add(&w->counters.tasks_executed, 1 + tp_run_lifo_slot(ex, w));
       continue;
     }
 
-    if (st == TEXEC_STATUS_CLOSED) {
-      break;
+    if (st == TEXEC_STATUS_REJECTED && (ex->spin_count || ex->yield_count)) {
+      st = tp_spin_for_work(ex, w, first, batch, batch_size, &n);
+      if (st == TEXEC_STATUS_NOT_READY) continue; // a deadline or LIFO slot task showed up
     }
 
-    // Defensive: exit on unexpected code
-    break;
+    if (st == TEXEC_STATUS_REJECTED) {
+      const unsigned int key = texec_event_count_prepare_wait(&ex->work_available);
+      if (atomic_load_explicit(&ex->edf_count, memory_order_seq_cst) != 0 || tp_lifo_pending(ex, w)) {
+        texec_event_count_cancel_wait(&ex->work_available);
+        continue;
+      }
+      st = tp_try_pop_batch(ex, w->node, first, batch, batch_size, &n);
+      if (st == TEXEC_STATUS_REJECTED) {
+        texec_worker_counters_transition(&w->counters, true);
+        atomic_fetch_add_explicit(&ex->idle_count, 1, memory_order_seq_cst);
+        const bool notified = tp_park(ex, key);
+        atomic_fetch_sub_explicit(&ex->idle_count, 1, memory_order_seq_cst);
+        // A retired worker's counters stay parked until its slot is reused
+        if (!notified && tp_try_retire(ex, w)) break;
+        texec_worker_counters_transition(&w->counters, false);
+        // Submitters skip the growth check while a worker is idle, so run it on the next pop
+        w->pops_until_grow_check = 1;
+        continue;
+      }
+      texec_event_count_cancel_wait(&ex->work_available);
+    }
+
+    // The deadline heap is closed before the run queues, so it only needs draining once more
+    if (st == TEXEC_STATUS_CLOSED && atomic_load_explicit(&ex->edf_count, memory_order_seq_cst) != 0) continue;
+
+    // CLOSED once drained; defensive: exit on unexpected code
+    if (st != TEXEC_STATUS_OK) break;
+
+    tp_note_dequeue(ex, w);
+    tp_wake_next(ex);
+    size_t executed = 0;
+    w->batch_next = 0;
+    w->batch_count = n;
+    while (w->batch_next < w->batch_count) {
+      texec_executor_consume_work_item(&ex->base, (texec_work_item_t*)batch[w->batch_next++]);
+      executed += 1 + tp_run_lifo_slot(ex, w);
+    }
+    texec_worker_counter_add(&w->counters.tasks_executed, executed);
+
+    // Take more per pop while the queue keeps filling whole batches, back off as it drains
+    if (n == batch_size && batch_size < TP_WORKER_MAX_BATCH) {
+      batch_size *= 2;
+    } else if (n < batch_size / 2) {
+      batch_size /= 2;
+    }
   }
 
+  texec_help_install(NULL);
+  tp_current_worker = NULL;
   return 0;
 }
 
-static texec_status_t tp_start_workers(thread_pool_executor_t* ex) {
+// Joins every worker thread that was started. The executor must no longer be RUNNING.
+static void tp_join_workers(thread_pool_executor_t* ex) {
   for (size_t i = 0; i < ex->thread_count; ++i) {
-    if (thrd_create(&ex->threads[i], &tp_worker_main, ex) != thrd_success) {
-      // Best effort: shut down already started threads
-      texec_queue_close(ex->q);
-      for (size_t j = 0; j < i; ++j) {
-        thrd_join(ex->threads[j], NULL);
+    if (ex->workers[i].state == TP_WORKER_EMPTY) continue;
+    thrd_join(ex->threads[i], NULL);
+    ex->workers[i].state = TP_WORKER_EMPTY;
+  }
+}
+
+static texec_status_t tp_start_workers(thread_pool_executor_t* ex) {
+  mtx_lock(&ex->mtx);
+  size_t started = 0;
+  while (started < ex->min_thread_count && tp_spawn_worker_locked(ex)) ++started;
+  if (started == ex->min_thread_count) {
+    mtx_unlock(&ex->mtx);
+    return TEXEC_STATUS_OK;
+  }
+
+  // Best effort: shut down already started threads
+  ex->base.state = TEXEC_EXECUTOR_STATE_CLOSING;
+  mtx_unlock(&ex->mtx);
+  tp_close_queues(ex);
+  texec_event_count_notify_all(&ex->work_available);
+  tp_join_workers(ex);
+  return TEXEC_STATUS_INTERNAL_ERROR;
+}
+
+static void tp_destroy_work_items(thread_pool_executor_t* ex, const uintptr_t* items, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    texec_work_item_destroy((texec_work_item_t*)items[i], ex->base.alloc);
+  }
+}
+
+// Enqueues `count` work items on the run queue of `level` on `node`, in bulk as far as
+// queue_capacity has room, and wakes a matching number of idle workers. Once the queues are full,
+// the policy decides what happens to the rest. Items that could not be enqueued are destroyed.
+static texec_status_t tp_enqueue_work_items(thread_pool_executor_t* ex,
+                                            size_t node,
+                                            tp_level_t level,
+                                            const uintptr_t* items,
+                                            size_t count,
+                                            texec_backpressure_policy_t backpressure) {
+  texec_queue_t* q = ex->nodes[node].queues[level];
+  size_t pushed = 0;
+  texec_status_t st = TEXEC_STATUS_OK;
+
+  while (pushed < count) {
+    size_t admitted = tp_try_admit(ex, count - pushed);
+    if (admitted == 0) {
+      if (backpressure == TEXEC_BACKPRESSURE_REJECT) {
+        atomic_fetch_add_explicit(&ex->rejected_count, count - pushed, memory_order_relaxed);
+        st = TEXEC_STATUS_REJECTED;
+        break;
+      }
+
+      if (backpressure == TEXEC_BACKPRESSURE_CALLER_RUNS) {
+        // Run one item inline each time the queues are full, then retry the rest in bulk
+        atomic_fetch_add_explicit(&ex->caller_runs_count, 1, memory_order_relaxed);
+        texec_executor_consume_work_item(&ex->base, (texec_work_item_t*)items[pushed++]);
+        continue;
       }
-      return TEXEC_STATUS_INTERNAL_ERROR;
+
+      assert(backpressure == TEXEC_BACKPRESSURE_BLOCK);
+      st = tp_admit(ex, count - pushed, &admitted);
+      if (st != TEXEC_STATUS_OK) break;
+    }
+
+    // The ring holds queue_capacity items, so only a closed queue takes fewer than were admitted
+    size_t n = 0;
+    st = texec_queue_try_push_many(q, items + pushed, admitted, &n);
+    pushed += n;
+    tp_notify_workers(ex, n);
+    if (n < admitted) {
+      tp_release_admitted(ex, admitted - n);
+      break;
     }
   }
-  return TEXEC_STATUS_OK;
+
+  tp_destroy_work_items(ex, items + pushed, count - pushed);
+  return st;
 }
 
+// Pushes a task with a deadline onto the EDF heap, which shares queue_capacity and the
+// backpressure policy with the run queues. Destroys `wi` if it could not be enqueued.
+static texec_status_t tp_enqueue_deadline_item(thread_pool_executor_t* ex,
+                                               texec_work_item_t* wi,
+                                               uint64_t deadline_ns,
+                                               texec_backpressure_policy_t backpressure) {
+  texec_status_t st = TEXEC_STATUS_OK;
+  size_t admitted = tp_try_admit(ex, 1);
+  if (admitted == 0 && backpressure == TEXEC_BACKPRESSURE_BLOCK) {
+    st = tp_admit(ex, 1, &admitted);
+  }
+
+  if (admitted != 0) {
+    mtx_lock(&ex->edf_mtx);
+    // The heap holds queue_capacity entries, so an admitted task always fits
+    if (ex->edf_closed || !texec_deadline_heap_push(&ex->edf, deadline_ns, (uintptr_t)wi)) {
+      st = TEXEC_STATUS_CLOSED;
+    } else {
+      atomic_store_explicit(&ex->edf_count, ex->edf.count, memory_order_seq_cst);
+    }
+    mtx_unlock(&ex->edf_mtx);
+
+    if (st == TEXEC_STATUS_OK) {
+      tp_notify_workers(ex, 1);
+      return st;
+    }
+    tp_release_admitted(ex, 1);
+  } else if (st == TEXEC_STATUS_OK) {
+    st = TEXEC_STATUS_REJECTED;
+  }
+
+  if (st == TEXEC_STATUS_REJECTED && backpressure == TEXEC_BACKPRESSURE_CALLER_RUNS) {
+    atomic_fetch_add_explicit(&ex->caller_runs_count, 1, memory_order_relaxed);
+    tp_consume_deadline_item(ex, wi, deadline_ns);
+    return TEXEC_STATUS_OK;
+  }
+
+  if (st == TEXEC_STATUS_REJECTED) {
+    atomic_fetch_add_explicit(&ex->rejected_count, 1, memory_order_relaxed);
+  }
+
+  texec_work_item_destroy(wi, ex->base.alloc);
+  return st;
+}
+
+static inline const texec_submit_deadline_info_t* tp_resolve_deadline(const texec_submit_info_t* info) {
+  return texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_DEADLINE);
+}
+
+static inline texec_status_t tp_resolve_level(const texec_submit_info_t* info, tp_level_t* out_level) {
+  const texec_submit_priority_info_t* pi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_PRIORITY);
+
+  switch (pi ? pi->priority : TEXEC_SUBMIT_PRIORITY_NORMAL) {
+  case TEXEC_SUBMIT_PRIORITY_HIGH:
+    *out_level = TP_LEVEL_HIGH;
+    return TEXEC_STATUS_OK;
+  case TEXEC_SUBMIT_PRIORITY_NORMAL:
+    *out_level = TP_LEVEL_NORMAL;
+    return TEXEC_STATUS_OK;
+  case TEXEC_SUBMIT_PRIORITY_LOW:
+    *out_level = TP_LEVEL_LOW;
+    return TEXEC_STATUS_OK;
+  default:
+    return TEXEC_STATUS_INVALID_ARGUMENT;
+  }
+}
+
+// Node whose run queues take the task: the one named by texec_submit_node_info_t, or else the
+// node of the submitting CPU.
+static inline texec_status_t tp_resolve_node(const thread_pool_executor_t* ex, const texec_submit_info_t* info, size_t* out_node) {
+  *out_node = 0;
+  if (!ex->numa_queues) return TEXEC_STATUS_OK;
+
+  const texec_submit_node_info_t* ni = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_NODE);
+  if (!ni) {
+    *out_node = texec_placement_current_group(&ex->placement);
+    return TEXEC_STATUS_OK;
+  }
+  return texec_placement_find_node(&ex->placement, ni->node, out_node) ? TEXEC_STATUS_OK : TEXEC_STATUS_INVALID_ARGUMENT;
+}
+
+static inline texec_backpressure_policy_t tp_resolve_backpressure(const thread_pool_executor_t* ex, const texec_submit_info_t* info) {
+  const texec_submit_backpressure_info_t* bpi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE);
+  return (bpi ? bpi->backpressure : ex->backpressure);
+}
+
+static inline const void* tp_resolve_trace_context(const texec_submit_info_t* info) {
+  const texec_submit_trace_context_info_t* tci = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_TRACE_CONTEXT);
+  return tci ? tci->trace_context : NULL;
+}
+
+static texec_status_t tp_dispatch_work_item(thread_pool_executor_t* ex,
+                                            texec_work_item_t* wi,
+                                            size_t node,
+                                            tp_level_t level,
+                                            const texec_submit_deadline_info_t* dli,
+                                            bool shared,
+                                            texec_backpressure_policy_t backpressure);
+
+// `h` may be NULL for detached submissions; `group`, if any, counts the task. The reference to
+// `h` passed in belongs to the work item, and is released if the submit fails.
+// Tasks with a deadline (`dli` non-NULL) bypass the priority run queues. Tasks submitted by one
+// of our workers go to its LIFO slot unless they are LOW priority, meant for another node, or
+// `shared` asks for the run queue.
 static texec_status_t tp_submit_with_handle(thread_pool_executor_t* ex,
                                             texec_task_t task,
+                                            const texec_submit_context_info_t* context,
                                             const void* trace_context,
+                                            texec_cancel_token_t* cancel,
                                             texec_backpressure_policy_t backpressure,
-                                            texec_task_handle_t* h) {
-  if (!ex || !h) return TEXEC_STATUS_INVALID_ARGUMENT;
+                                            size_t node,
+                                            tp_level_t level,
+                                            const texec_submit_deadline_info_t* dli,
+                                            bool shared,
+                                            texec_task_handle_t* h,
+                                            texec_task_group_t* group) {
+  if (!ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (tp_get_state(ex) != TEXEC_EXECUTOR_STATE_RUNNING) {
+    texec_task_handle_release(h);
+    return TEXEC_STATUS_CLOSED;
+  }
 
-  if (tp_get_state(ex) != TEXEC_EXECUTOR_STATE_RUNNING) return TEXEC_STATUS_CLOSED;
+  if (group) {
+    texec_status_t st = texec_task_group_enter(group, 1);
+    if (st != TEXEC_STATUS_OK) {
+      texec_task_handle_release(h);
+      return st;
+    }
+  }
 
-  texec_work_item_t* wi = texec_work_item_allocate(ex->base.alloc);
-  if (!wi) return TEXEC_STATUS_OUT_OF_MEMORY;
+  texec_work_item_t* wi = texec_executor_allocate_work_item(&ex->base);
+  if (!wi) {
+    if (group) texec_task_group_leave(group, 1);
+    texec_task_handle_release(h);
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
 
   wi->task = task;
   wi->handle = h;
+  wi->group = group;
   wi->trace_context = trace_context;
+  texec_work_item_set_cancel_token(wi, cancel);
 
-  texec_status_t st = TEXEC_STATUS_INTERNAL_ERROR;
+  if (context && !texec_work_item_copy_context(wi, ex->base.alloc, context)) {
+    texec_work_item_destroy(wi, ex->base.alloc); // releases `h` and leaves `group`
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
 
-  switch (backpressure) {
-  case TEXEC_BACKPRESSURE_REJECT:
-    st = texec_queue_try_push_ptr(ex->q, wi);
-    break;
-  
-  case TEXEC_BACKPRESSURE_BLOCK:
-    st = texec_queue_push_ptr(ex->q, wi);
-    break;
+  return tp_dispatch_work_item(ex, wi, node, level, dli, shared, backpressure);
+}
 
-  case TEXEC_BACKPRESSURE_CALLER_RUNS:
-    st = texec_queue_try_push_ptr(ex->q, wi);
-    if (st == TEXEC_STATUS_REJECTED) {
-      texec_executor_consume_work_item(&ex->base, wi);
-      st = TEXEC_STATUS_OK;
+// Puts `wi` in the worker's LIFO slot and wakes an idle worker, which takes it if the submitting
+// task runs on for long. The task it displaces moves to the back of its run queue; if that queue
+// is full or closed, the displaced task keeps the slot and `wi` is enqueued under `backpressure`
+// like any other submit instead.
+static texec_status_t tp_lifo_push(thread_pool_executor_t* ex,
+                                   tp_worker_t* w,
+                                   texec_work_item_t* wi,
+                                   tp_level_t level,
+                                   texec_backpressure_policy_t backpressure) {
+  const tp_level_t prev_level = w->lifo_level;
+  w->lifo_level = level;
+  texec_work_item_t* prev = atomic_exchange_explicit(&w->lifo, wi, memory_order_seq_cst);
+
+  if (prev && !tp_try_push_admitted(ex, w->node, prev_level, prev)) {
+    w->lifo_level = prev_level;
+    // NULL if an idle worker already took `wi`
+    texec_work_item_t* back = atomic_exchange_explicit(&w->lifo, prev, memory_order_seq_cst);
+    if (back) {
+      const uintptr_t item = (uintptr_t)back;
+      return tp_enqueue_work_items(ex, w->node, level, &item, 1, backpressure);
     }
-    break;
-  
-  default:
-    assert(false);
-    break;
   }
 
-  if (st != TEXEC_STATUS_OK) {
-    texec_work_item_destroy(wi, ex->base.alloc);
+  tp_notify_workers(ex, 1);
+  return TEXEC_STATUS_OK;
+}
+
+// Queues `wi` on the deadline heap if it has a deadline, else in the submitting worker's LIFO
+// slot or on a run queue. Destroys it if it could not be enqueued.
+static texec_status_t tp_dispatch_work_item(thread_pool_executor_t* ex,
+                                            texec_work_item_t* wi,
+                                            size_t node,
+                                            tp_level_t level,
+                                            const texec_submit_deadline_info_t* dli,
+                                            bool shared,
+                                            texec_backpressure_policy_t backpressure) {
+  if (dli) {
+    return tp_enqueue_deadline_item(ex, wi, dli->deadline_ns, backpressure);
   }
 
-  return st;
+  tp_worker_t* w = tp_local_worker(ex);
+  if (w && !shared && level != TP_LEVEL_LOW && node == w->node) {
+    return tp_lifo_push(ex, w, wi, level, backpressure);
+  }
+
+  const uintptr_t item = (uintptr_t)wi;
+  return tp_enqueue_work_items(ex, node, level, &item, 1, backpressure);
+}
+
+static void tp_close_deadline_heap(thread_pool_executor_t* ex) {
+  mtx_lock(&ex->edf_mtx);
+  ex->edf_closed = true;
+  mtx_unlock(&ex->edf_mtx);
 }
 
 static texec_executor_state_t tp_close(thread_pool_executor_t* ex) {
@@ -152,18 +970,20 @@ static texec_executor_state_t tp_close(thread_pool_executor_t* ex) {
   const texec_executor_state_t original_state = ex->base.state;
   if (original_state == TEXEC_EXECUTOR_STATE_RUNNING) {
     ex->base.state = TEXEC_EXECUTOR_STATE_CLOSING;
-    texec_queue_close(ex->q);
+    tp_close_deadline_heap(ex);
+    tp_close_queues(ex);
   }
   mtx_unlock(&ex->mtx);
+  texec_event_count_notify_all(&ex->work_available);
+  texec_event_count_notify_all(&ex->space_available);
   return original_state;
 }
 
 static void tp_join(thread_pool_executor_t* ex) {
   if (tp_close(ex) == TEXEC_EXECUTOR_STATE_CLOSED) return;
 
-  for (size_t i = 0; i < ex->thread_count; ++i) {
-    thrd_join(ex->threads[i], NULL);
-  }
+  // No worker starts or retires once the executor is closing
+  tp_join_workers(ex);
 
   mtx_lock(&ex->mtx);
   ex->base.state = TEXEC_EXECUTOR_STATE_CLOSED;
@@ -171,8 +991,7 @@ static void tp_join(thread_pool_executor_t* ex) {
 }
 
 static texec_status_t tp_vtbl_submit(texec_executor_t* ex,  const texec_submit_info_t* info, texec_task_handle_t** out_handle) {
-  if (!out_handle) return TEXEC_STATUS_INVALID_ARGUMENT;
-  *out_handle = NULL;
+  if (out_handle) *out_handle = NULL;
   
   thread_pool_executor_t* tp_ex = tp_from_base(ex);
   if (!tp_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
@@ -183,13 +1002,26 @@ static texec_status_t tp_vtbl_submit(texec_executor_t* ex,  const texec_submit_i
 
   if (!info->task.run) return TEXEC_STATUS_INVALID_ARGUMENT;
 
-  const texec_submit_backpressure_info_t* bpi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE);
-  const texec_backpressure_policy_t backpressure = (bpi ? bpi->backpressure : tp_ex->backpressure);
+  tp_level_t level = TP_LEVEL_NORMAL;
+  if (tp_resolve_level(info, &level) != TEXEC_STATUS_OK) return TEXEC_STATUS_INVALID_ARGUMENT;
 
-  const texec_submit_trace_context_info_t* tci = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_TRACE_CONTEXT);
-  const void* trace_context = tci ? tci->trace_context : NULL;
+  size_t node = 0;
+  if (tp_resolve_node(tp_ex, info, &node) != TEXEC_STATUS_OK) return TEXEC_STATUS_INVALID_ARGUMENT;
 
-  texec_task_handle_t* h = texec_task_handle_create(tp_ex->base.alloc);
+  const texec_backpressure_policy_t backpressure = tp_resolve_backpressure(tp_ex, info);
+  const void* trace_context = tp_resolve_trace_context(info);
+  const texec_submit_deadline_info_t* dli = tp_resolve_deadline(info);
+  texec_task_group_t* group = texec_executor_find_submit_group(info);
+  texec_cancel_token_t* cancel = texec_executor_find_submit_cancel_token(info, group);
+  const bool shared = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_INTERNAL_SHARED) != NULL;
+  const texec_submit_context_info_t* context = texec_executor_find_submit_context(info);
+
+  if (!out_handle) {
+    // Detached: only the work item is built, completion is observed through task.on_complete
+    return tp_submit_with_handle(tp_ex, info->task, context, trace_context, cancel, backpressure, node, level, dli, shared, NULL, group);
+  }
+
+  texec_task_handle_t* h = texec_executor_create_submit_handle(&tp_ex->base, info);
   if (!h) return TEXEC_STATUS_OUT_OF_MEMORY;
 
   if (texec_task_handle_retain(h) != TEXEC_STATUS_OK) {
@@ -197,7 +1029,7 @@ static texec_status_t tp_vtbl_submit(texec_executor_t* ex,  const texec_submit_i
     return TEXEC_STATUS_INTERNAL_ERROR;
   }
 
-  texec_status_t st = tp_submit_with_handle(tp_ex, info->task, trace_context, backpressure, h);
+  texec_status_t st = tp_submit_with_handle(tp_ex, info->task, context, trace_context, cancel, backpressure, node, level, dli, shared, h, group);
   if (st != TEXEC_STATUS_OK) {
     texec_task_handle_release(h);
     return st;
@@ -207,32 +1039,145 @@ static texec_status_t tp_vtbl_submit(texec_executor_t* ex,  const texec_submit_i
   return st;
 }
 
+static texec_status_t tp_vtbl_submit_intrusive(texec_executor_t* ex, const texec_submit_intrusive_info_t* info) {
+  thread_pool_executor_t* tp_ex = tp_from_base(ex);
+  if (!tp_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  // The resolvers only look at the extension chain
+  const texec_submit_info_t chain = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_INFO, info->header.next},
+    .task = info->task->task,
+  };
+
+  tp_level_t level = TP_LEVEL_NORMAL;
+  if (tp_resolve_level(&chain, &level) != TEXEC_STATUS_OK) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  size_t node = 0;
+  if (tp_resolve_node(tp_ex, &chain, &node) != TEXEC_STATUS_OK) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (tp_get_state(tp_ex) != TEXEC_EXECUTOR_STATE_RUNNING) return TEXEC_STATUS_CLOSED;
+
+  return tp_dispatch_work_item(tp_ex, texec_work_item_from_intrusive(info->task), node, level, tp_resolve_deadline(&chain), false,
+                               tp_resolve_backpressure(tp_ex, &chain));
+}
+
+// Builds a work item counted by `g` (already entered by the caller) for `info`.
+static texec_work_item_t* tp_allocate_group_work_item(thread_pool_executor_t* ex, const texec_submit_info_t* info, texec_task_group_t* g) {
+  texec_work_item_t* wi = texec_executor_allocate_work_item(&ex->base);
+  if (!wi) return NULL;
+
+  wi->task = info->task;
+  wi->handle = NULL;
+  wi->group = NULL; // set once nothing can fail: the caller still counts the task for `g`
+  wi->trace_context = tp_resolve_trace_context(info);
+  wi->cancel = NULL;
+
+  const texec_submit_context_info_t* context = texec_executor_find_submit_context(info);
+  if (context && !texec_work_item_copy_context(wi, ex->base.alloc, context)) {
+    texec_work_item_destroy(wi, ex->base.alloc);
+    return NULL;
+  }
+
+  wi->group = g;
+  texec_work_item_set_cancel_token(wi, texec_executor_find_submit_cancel_token(info, g));
+  return wi;
+}
+
 static texec_status_t tp_vtbl_submit_many(texec_executor_t* ex, const texec_submit_info_t* infos, size_t count, texec_task_group_t** out_group) {
   if (!out_group) return TEXEC_STATUS_INVALID_ARGUMENT;
   *out_group = NULL;
 
-  if (!tp_is_thread_pool(ex)) return TEXEC_STATUS_INVALID_ARGUMENT;
+  thread_pool_executor_t* tp_ex = tp_from_base(ex);
+  if (!tp_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (count && !infos) return TEXEC_STATUS_INVALID_ARGUMENT;
 
+  for (size_t i = 0; i < count; ++i) {
+    tp_level_t level = TP_LEVEL_NORMAL;
+    size_t node = 0;
+    if (infos[i].header.type != TEXEC_STRUCT_TYPE_SUBMIT_INFO || !infos[i].task.run || tp_resolve_level(&infos[i], &level) != TEXEC_STATUS_OK ||
+        tp_resolve_node(tp_ex, &infos[i], &node) != TEXEC_STATUS_OK) {
+      return TEXEC_STATUS_INVALID_ARGUMENT;
+    }
+  }
+
+  // Tasks are only counted by the group, no per-task handles
   const texec_task_group_create_info_t gi = {
     .header = {.type = TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_INFO, .next = NULL},
-    .capacity = count,
+    .capacity = 0,
   };
 
   texec_task_group_t* g = NULL;
   texec_status_t st = texec_task_group_create(&gi, ex->alloc, &g);
   if (st != TEXEC_STATUS_OK) return st;
 
-  for (size_t i = 0; i < count; ++i) {
-    texec_task_handle_t* h = NULL;
-    st = tp_vtbl_submit(ex, &infos[i], &h);
-    if (st != TEXEC_STATUS_OK) break;
-    st = texec_task_group_add(g, h);
-    texec_task_handle_release(h);
-    if (st != TEXEC_STATUS_OK) break;
+  if (count == 0) {
+    *out_group = g;
+    return TEXEC_STATUS_OK;
   }
 
+  st = (tp_get_state(tp_ex) == TEXEC_EXECUTOR_STATE_RUNNING) ? texec_task_group_enter(g, count) : TEXEC_STATUS_CLOSED;
   if (st != TEXEC_STATUS_OK) {
     texec_task_group_destroy(g);
+    return st;
+  }
+
+  // Build work items in chunks and push each run of items sharing a node, priority and backpressure policy at once
+  uintptr_t items[TP_SUBMIT_BATCH];
+  size_t i = 0;
+
+  while (st == TEXEC_STATUS_OK && i < count) {
+    const texec_backpressure_policy_t backpressure = tp_resolve_backpressure(tp_ex, &infos[i]);
+
+    // Tasks with a deadline go to the EDF heap one at a time
+    const texec_submit_deadline_info_t* dli = tp_resolve_deadline(&infos[i]);
+    if (dli) {
+      texec_work_item_t* wi = tp_allocate_group_work_item(tp_ex, &infos[i], g);
+      if (!wi) {
+        st = TEXEC_STATUS_OUT_OF_MEMORY;
+        break;
+      }
+      ++i;
+      st = tp_enqueue_deadline_item(tp_ex, wi, dli->deadline_ns, backpressure);
+      continue;
+    }
+
+    tp_level_t level = TP_LEVEL_NORMAL;
+    tp_resolve_level(&infos[i], &level);
+    size_t node = 0;
+    tp_resolve_node(tp_ex, &infos[i], &node);
+
+    size_t n = 0;
+    tp_level_t next_level = level;
+    size_t next_node = node;
+    while (n < TP_SUBMIT_BATCH && i < count && !tp_resolve_deadline(&infos[i]) &&
+           tp_resolve_level(&infos[i], &next_level) == TEXEC_STATUS_OK && next_level == level &&
+           tp_resolve_node(tp_ex, &infos[i], &next_node) == TEXEC_STATUS_OK && next_node == node &&
+           tp_resolve_backpressure(tp_ex, &infos[i]) == backpressure) {
+      texec_work_item_t* wi = tp_allocate_group_work_item(tp_ex, &infos[i], g);
+      if (!wi) {
+        st = TEXEC_STATUS_OUT_OF_MEMORY;
+        break;
+      }
+
+      items[n++] = (uintptr_t)wi;
+      ++i;
+    }
+
+    if (st != TEXEC_STATUS_OK) {
+      tp_destroy_work_items(tp_ex, items, n);
+      break;
+    }
+
+    st = tp_enqueue_work_items(tp_ex, node, level, items, n, backpressure);
+  }
+
+  // Work items that were never built still hold their share of the count
+  texec_task_group_leave(g, count - i);
+
+  if (st != TEXEC_STATUS_OK) {
+    // Already queued tasks keep running; the group is freed once they finish
+    texec_task_group_destroy(g);
   } else {
     *out_group = g;
   }
@@ -255,14 +1200,37 @@ static texec_status_t tp_vtbl_destroy(texec_executor_t* ex) {
   thread_pool_executor_t* tp_ex = tp_from_base(ex);
   if (!tp_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
   if (tp_get_state(tp_ex) != TEXEC_EXECUTOR_STATE_CLOSED) return TEXEC_STATUS_BUSY;
+  texec_executor_release_timers(ex);
   return tp_destroy_unchecked(tp_ex);
 }
 
+static void tp_query_worker_metrics(const thread_pool_executor_t* ex, texec_worker_metrics_t* out) {
+  const uint64_t now = texec_clock_now_ns();
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    texec_worker_counters_snapshot(&ex->workers[i].counters, now, &out[i]);
+  }
+}
+
+static void tp_query_metrics(const thread_pool_executor_t* ex, texec_executor_metrics_t* out) {
+  *out = (texec_executor_metrics_t){0};
+
+  const uint64_t now = texec_clock_now_ns();
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    texec_worker_metrics_t w;
+    texec_worker_counters_snapshot(&ex->workers[i].counters, now, &w);
+    texec_executor_metrics_accumulate(out, &w);
+  }
+
+  out->queue_depth = tp_queue_depth(ex);
+  out->rejected_submits = atomic_load_explicit(&ex->rejected_count, memory_order_relaxed);
+  out->caller_runs = atomic_load_explicit(&ex->caller_runs_count, memory_order_relaxed);
+}
+
 static texec_status_t tp_vtbl_query(const texec_executor_t* ex, texec_executor_capability_t cap, void* out_value) {
   if (!out_value) return TEXEC_STATUS_INVALID_ARGUMENT;
 
   const thread_pool_executor_t* tp_ex = tp_from_const_base(ex);
-  if (!ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (!tp_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
 
   switch (cap){
   case TEXEC_EXECUTOR_CAPABILITY_WORKER_COUNT:
@@ -270,16 +1238,40 @@ static texec_status_t tp_vtbl_query(const texec_executor_t* ex, texec_executor_c
     return TEXEC_STATUS_OK;
     
   case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_PRIORITY:
-    *(bool*)out_value = false;
+    *(bool*)out_value = true;
     return TEXEC_STATUS_OK;
   
   case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_DEADLINE:
-    *(bool*)out_value = false;
+    *(bool*)out_value = true;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_EXPIRED_COUNT:
+    *(uint64_t*)out_value = atomic_load_explicit(&tp_ex->expired_count, memory_order_relaxed);
     return TEXEC_STATUS_OK;
   
   case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_TRACING:
     *(bool*)out_value = true;
     return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_METRICS:
+    tp_query_metrics(tp_ex, (texec_executor_metrics_t*)out_value);
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_WORKER_METRICS:
+    tp_query_worker_metrics(tp_ex, (texec_worker_metrics_t*)out_value);
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_LIVE_WORKER_COUNT:
+    *(size_t*)out_value = atomic_load_explicit(&tp_ex->live_count, memory_order_relaxed);
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_IDLE_WORKER_COUNT:
+    *(size_t*)out_value = atomic_load_explicit(&tp_ex->idle_count, memory_order_relaxed);
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_NODE_COUNT:
+    *(size_t*)out_value = tp_ex->node_count;
+    return TEXEC_STATUS_OK;
   
   default:
     break;
@@ -299,6 +1291,7 @@ texec_status_t texec_executor_create_thread_pool(const texec_thread_pool_executo
 
   static const texec_executor_vtable_t vtbl_instance = {
     .submit = tp_vtbl_submit,
+    .submit_intrusive = tp_vtbl_submit_intrusive,
     .submit_many = tp_vtbl_submit_many,
     .close = tp_vtbl_close,
     .join = tp_vtbl_join,
@@ -309,37 +1302,131 @@ texec_status_t texec_executor_create_thread_pool(const texec_thread_pool_executo
   tp_ex->base.vtbl = &vtbl_instance;
   tp_ex->base.alloc = cfg->alloc;
   tp_ex->base.diag = cfg->diag;
+  tp_ex->base.work_item_pool = NULL;
+  tp_ex->base.handle_pool = NULL;
+  atomic_init(&tp_ex->base.timers, NULL);
   tp_ex->base.kind = TEXEC_EXECUTOR_KIND_THREAD_POOL;
   tp_ex->base.state = TEXEC_EXECUTOR_STATE_RUNNING;
-  tp_ex->q = NULL;
+  tp_ex->nodes = NULL;
+  tp_ex->node_count = 0;
+  tp_ex->numa_queues = false;
+  tp_ex->placement = (texec_placement_t){.alloc = cfg->alloc};
+  tp_ex->workers = NULL;
   tp_ex->threads = NULL;
   tp_ex->thread_count = 0;
   tp_ex->backpressure = cfg->backpressure;
+  tp_ex->min_thread_count = cfg->min_thread_count;
+  tp_ex->idle_timeout_ns = cfg->idle_timeout_ns;
+  tp_ex->grow_queue_depth = cfg->grow_queue_depth;
+  tp_ex->grow_sojourn_ns = cfg->grow_sojourn_ns;
+  atomic_init(&tp_ex->live_count, 0);
+  atomic_init(&tp_ex->idle_count, 0);
+  atomic_init(&tp_ex->last_dequeue_ns, texec_clock_now_ns());
+  texec_event_count_init(&tp_ex->work_available);
+  tp_ex->queue_capacity = cfg->queue_capacity;
+  atomic_init(&tp_ex->admitted_count, 0);
+  texec_event_count_init(&tp_ex->space_available);
+  tp_ex->spin_count = cfg->spin_count;
+  tp_ex->yield_count = cfg->yield_count;
+  atomic_init(&tp_ex->spinning_count, 0);
+  tp_ex->edf.entries = NULL;
+  tp_ex->edf_closed = false;
+  atomic_init(&tp_ex->edf_count, 0);
+  tp_ex->deadline_policy = cfg->deadline_policy;
+  atomic_init(&tp_ex->expired_count, 0);
+  atomic_init(&tp_ex->rejected_count, 0);
+  atomic_init(&tp_ex->caller_runs_count, 0);
 
   if (mtx_init(&tp_ex->mtx, mtx_plain) != thrd_success) {
     tp_free(tp_ex);
     return TEXEC_STATUS_INTERNAL_ERROR;
   }
 
-  thrd_t* threads = texec_allocate(tp_ex->base.alloc, cfg->thread_count * sizeof(thrd_t), _Alignof(thrd_t));
-  if (!threads) {
+  if (mtx_init(&tp_ex->edf_mtx, mtx_plain) != thrd_success) {
+    mtx_destroy(&tp_ex->mtx);
+    tp_free(tp_ex);
+    return TEXEC_STATUS_INTERNAL_ERROR;
+  }
+
+  texec_status_t st = texec_executor_init_pools(&tp_ex->base, &cfg->pool);
+  if (st != TEXEC_STATUS_OK) {
+    mtx_destroy(&tp_ex->edf_mtx);
+    mtx_destroy(&tp_ex->mtx);
+    tp_free(tp_ex);
+    return st;
+  }
+
+  st = texec_placement_init(&tp_ex->placement, cfg->affinity, tp_ex->base.alloc);
+  if (st != TEXEC_STATUS_OK) {
     tp_destroy_unchecked(tp_ex);
-    return TEXEC_STATUS_OUT_OF_MEMORY;
+    return st;
   }
+
+  // Without affinity support there are no nodes to tell apart
+  const bool numa_queues = cfg->affinity && cfg->affinity->numa_queues && tp_ex->placement.group_count != 0;
+  tp_ex->numa_queues = numa_queues;
+  const size_t node_count = numa_queues ? texec_placement_group_count(&tp_ex->placement) : 1;
+
+  tp_node_t* nodes = texec_allocate(tp_ex->base.alloc, node_count * sizeof(tp_node_t), _Alignof(tp_node_t));
+  thrd_t* threads = texec_allocate(tp_ex->base.alloc, cfg->thread_count * sizeof(thrd_t), _Alignof(thrd_t));
+  tp_worker_t* workers = texec_allocate(tp_ex->base.alloc, cfg->thread_count * sizeof(tp_worker_t), _Alignof(tp_worker_t));
+  tp_ex->nodes = nodes;
   tp_ex->threads = threads;
+  tp_ex->workers = workers;
   tp_ex->thread_count = cfg->thread_count;
+  if (nodes) {
+    tp_ex->node_count = node_count;
+    for (size_t node = 0; node < node_count; ++node) {
+      for (size_t level = 0; level < TP_LEVEL_COUNT; ++level) {
+        nodes[node].queues[level] = NULL;
+      }
+    }
+  }
+  if (!nodes || !threads || !workers) {
+    tp_destroy_unchecked(tp_ex);
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+
+  for (size_t i = 0; i < tp_ex->thread_count; ++i) {
+    texec_worker_counters_init(&workers[i].counters);
+    workers[i].ex = tp_ex;
+    workers[i].state = TP_WORKER_EMPTY;
+    atomic_init(&workers[i].lifo, NULL);
+    workers[i].node = numa_queues ? texec_placement_worker_group(&tp_ex->placement, i) : 0;
+    texec_placement_worker_cpus(&tp_ex->placement, i, &workers[i].cpus, &workers[i].cpu_count);
+    atomic_store_explicit(&workers[i].counters.parked, true, memory_order_relaxed); // idle until started
+  }
 
+  const texec_queue_create_mode_info_t qmi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_QUEUE_CREATE_MODE_INFO, .next = NULL},
+    .mode = TEXEC_QUEUE_MODE_LOCK_FREE,
+  };
   const texec_queue_create_info_t qi = {
-    .header = {.type = TEXEC_STRUCT_TYPE_QUEUE_CREATE_INFO, .next = NULL},
+    .header = {.type = TEXEC_STRUCT_TYPE_QUEUE_CREATE_INFO, .next = &qmi},
     .capacity = cfg->queue_capacity,
   };
-  texec_queue_t* q = NULL;
-  texec_status_t st = texec_queue_create(&qi, tp_ex->base.alloc, &q);
+  st = texec_deadline_heap_init(&tp_ex->edf, cfg->queue_capacity, tp_ex->base.alloc);
+  if (st != TEXEC_STATUS_OK) {
+    tp_destroy_unchecked(tp_ex);
+    return st;
+  }
+
+  // Each priority level of each node gets its own run queue. Any one of them may hold every
+  // admitted task, so each is sized to `queue_capacity`. Creating them from the node's CPUs lets
+  // first-touch page placement put the rings in that node's memory.
+  for (size_t node = 0; node < node_count && st == TEXEC_STATUS_OK; ++node) {
+    if (numa_queues) texec_placement_enter_group(&tp_ex->placement, node);
+    for (size_t level = 0; level < TP_LEVEL_COUNT && st == TEXEC_STATUS_OK; ++level) {
+      st = texec_queue_create(&qi, tp_ex->base.alloc, &nodes[node].queues[level]);
+    }
+  }
+  if (numa_queues) texec_placement_leave_group(&tp_ex->placement);
+
   if (st != TEXEC_STATUS_OK) {
+    tp_close_queues(tp_ex);
     tp_destroy_unchecked(tp_ex);
     return st;
   }
-  tp_ex->q = q;
 
   st = tp_start_workers(tp_ex);
   if (st != TEXEC_STATUS_OK) {
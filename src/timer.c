@@ -0,0 +1,419 @@
+#include "texec/timer.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+#include "texec/clock.h"
+
+#include "internal/allocator.h"
+#include "internal/executor.h"
+#include "internal/futex.h"
+#include "internal/timer.h"
+#include "internal/timer_wheel.h"
+
+// Wheel resolution: timers fire on the first tick at or after their due time.
+static const uint64_t TIMER_TICK_NS = 1000000u;
+
+typedef enum timer_state {
+  TIMER_ARMED,    // linked in the wheel
+  TIMER_RUNNING,  // handed to the executor; its completion re-arms or finishes the timer
+  TIMER_FINISHED,
+} timer_state_t;
+
+struct texec_timer {
+  texec_timer_wheel_entry_t entry; // first member: wheel entries cast back to timers
+  atomic_uint refcount;            // the caller's, plus the service's until the timer finishes
+  texec_timer_service_t* service;
+  timer_state_t state;             // guarded by service->mtx, like `cancelled` and `due_ns`
+  bool cancelled;
+  uint64_t due_ns;
+  uint64_t period_ns;
+  texec_task_t task;
+  texec_context_copy_t context; // task.ctx points into it when scheduled with a context blob
+
+  bool has_priority;
+  bool has_trace_context;
+  bool has_node;
+  bool has_cancel;
+  texec_submit_priority_info_t priority;
+  texec_submit_trace_context_info_t trace_context;
+  texec_submit_node_info_t node;
+  texec_submit_cancel_info_t cancel; // holds a reference to the token
+};
+
+struct texec_timer_service {
+  texec_executor_t* ex;
+  const texec_allocator_t* alloc;
+  atomic_uint refcount; // the executor's, plus one per timer
+  mtx_t mtx;
+  texec_timer_wheel_t wheel;
+  uint64_t origin_ns;   // tick 0
+  uint64_t sleep_until; // tick the timer thread sleeps until; UINT64_MAX while the wheel is empty
+  atomic_uint wake_seq; // futex word the timer thread sleeps on
+  bool closed;
+  bool joined;
+  thrd_t thread;
+};
+
+// Stands in for the service of executors closed before they scheduled anything.
+static texec_timer_service_t timer_service_closed;
+
+static inline bool timer_service_is_real(const texec_timer_service_t* s) {
+  return s && s != &timer_service_closed;
+}
+
+static inline texec_timer_t* timer_from_entry(texec_timer_wheel_entry_t* e) {
+  return (texec_timer_t*)e;
+}
+
+static inline uint64_t timer_service_now_tick(const texec_timer_service_t* s) {
+  return (texec_clock_now_ns() - s->origin_ns) / TIMER_TICK_NS;
+}
+
+static void timer_service_release(texec_timer_service_t* s) {
+  if (atomic_fetch_sub_explicit(&s->refcount, 1u, memory_order_acq_rel) != 1u) return;
+  mtx_destroy(&s->mtx);
+  texec_free(s->alloc, s, sizeof(*s), _Alignof(texec_timer_service_t));
+}
+
+static void timer_service_wake(texec_timer_service_t* s) {
+  atomic_fetch_add_explicit(&s->wake_seq, 1u, memory_order_release);
+  texec_futex_wake_one(&s->wake_seq);
+}
+
+void texec_timer_release(texec_timer_t* t) {
+  if (!t) return;
+  if (atomic_fetch_sub_explicit(&t->refcount, 1u, memory_order_acq_rel) != 1u) return;
+
+  texec_timer_service_t* s = t->service;
+  if (t->has_cancel) texec_cancel_token_release(t->cancel.token);
+  texec_context_copy_release(&t->context, s->alloc);
+  texec_free(s->alloc, t, sizeof(*t), _Alignof(texec_timer_t));
+  timer_service_release(s);
+}
+
+// Links `t` into the wheel for its due time, cutting the timer thread's sleep short if it now
+// has to wake up earlier. Called with the service lock held.
+static void timer_arm_locked(texec_timer_service_t* s, texec_timer_t* t) {
+  const uint64_t since_origin = t->due_ns > s->origin_ns ? t->due_ns - s->origin_ns : 0;
+  uint64_t when = (since_origin + TIMER_TICK_NS - 1) / TIMER_TICK_NS;
+  if (when <= s->wheel.elapsed) when = s->wheel.elapsed + 1;
+
+  t->entry.when = when;
+  t->state = TIMER_ARMED;
+  texec_timer_wheel_insert(&s->wheel, &t->entry);
+
+  if (when < s->sleep_until) {
+    s->sleep_until = when;
+    timer_service_wake(s);
+  }
+}
+
+// Runs once per timer, without the service lock, after its state became TIMER_FINISHED.
+static void timer_finish(texec_timer_t* t, texec_status_t reason) {
+  if (reason == TEXEC_STATUS_OK) {
+    texec_task_on_complete(&t->task);
+  } else {
+    const void* trace_context = t->has_trace_context ? t->trace_context.trace_context : NULL;
+    texec_executor_drop_task(t->service->ex, &t->task, trace_context, NULL, reason);
+  }
+  texec_timer_release(t);
+}
+
+static int timer_run(void* ctx) {
+  const texec_timer_t* t = ctx;
+  return t->task.run(t->task.ctx);
+}
+
+// Next due time of a periodic timer, skipping the periods that have already gone by.
+static inline uint64_t timer_next_due(uint64_t due_ns, uint64_t period_ns, uint64_t now_ns) {
+  if (due_ns + period_ns > now_ns) return due_ns + period_ns;
+  return due_ns + ((now_ns - due_ns) / period_ns + 1) * period_ns;
+}
+
+static inline bool timer_token_cancelled(const texec_timer_t* t) {
+  return t->has_cancel && texec_cancel_token_is_cancelled(t->cancel.token);
+}
+
+// on_complete of every run, whether the executor ran or dropped it. A cancelled token ends the
+// timer like texec_timer_cancel, but reports TEXEC_STATUS_CANCELLED.
+static void timer_run_complete(void* ctx) {
+  texec_timer_t* t = ctx;
+  texec_timer_service_t* s = t->service;
+  const bool token_cancelled = timer_token_cancelled(t);
+
+  mtx_lock(&s->mtx);
+  if (t->period_ns && !t->cancelled && !token_cancelled && !s->closed) {
+    t->due_ns = timer_next_due(t->due_ns, t->period_ns, texec_clock_now_ns());
+    timer_arm_locked(s, t);
+    mtx_unlock(&s->mtx);
+    return;
+  }
+  t->state = TIMER_FINISHED;
+  mtx_unlock(&s->mtx);
+
+  timer_finish(t, token_cancelled ? TEXEC_STATUS_CANCELLED : TEXEC_STATUS_OK);
+}
+
+// The timer thread must never block or run tasks itself, so full executors reject the run.
+static texec_status_t timer_submit(texec_timer_service_t* s, texec_timer_t* t) {
+  texec_submit_backpressure_info_t backpressure = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE, NULL},
+    .backpressure = TEXEC_BACKPRESSURE_REJECT,
+  };
+  const void* chain = &backpressure;
+
+  if (t->has_priority) { t->priority.header.next = chain; chain = &t->priority; }
+  if (t->has_trace_context) { t->trace_context.header.next = chain; chain = &t->trace_context; }
+  if (t->has_node) { t->node.header.next = chain; chain = &t->node; }
+  if (t->has_cancel) { t->cancel.header.next = chain; chain = &t->cancel; }
+
+  const texec_submit_info_t info = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_INFO, chain},
+    .task = {.run = timer_run, .ctx = t, .on_complete = timer_run_complete},
+  };
+  return s->ex->vtbl->submit(s->ex, &info, NULL);
+}
+
+// A full executor gets the run again on the next tick; any other failure ends the timer.
+static void timer_submit_failed(texec_timer_service_t* s, texec_timer_t* t, texec_status_t st) {
+  mtx_lock(&s->mtx);
+  if (st == TEXEC_STATUS_REJECTED && !t->cancelled && !s->closed) {
+    timer_arm_locked(s, t);
+    mtx_unlock(&s->mtx);
+    return;
+  }
+  if (s->closed) st = TEXEC_STATUS_CLOSED;
+  t->state = TIMER_FINISHED;
+  mtx_unlock(&s->mtx);
+
+  timer_finish(t, t->cancelled && st != TEXEC_STATUS_CLOSED ? TEXEC_STATUS_OK : st);
+}
+
+static int timer_thread_main(void* arg) {
+  texec_timer_service_t* s = arg;
+
+  mtx_lock(&s->mtx);
+  while (!s->closed) {
+    texec_timer_wheel_entry_t* due = texec_timer_wheel_advance(&s->wheel, timer_service_now_tick(s));
+    if (due) {
+      for (texec_timer_wheel_entry_t* e = due; e; e = e->next) timer_from_entry(e)->state = TIMER_RUNNING;
+      mtx_unlock(&s->mtx);
+
+      while (due) {
+        texec_timer_t* t = timer_from_entry(due);
+        due = due->next; // the run may re-arm `t` before submit returns
+        const texec_status_t st = timer_submit(s, t);
+        if (st != TEXEC_STATUS_OK) timer_submit_failed(s, t, st);
+      }
+
+      mtx_lock(&s->mtx);
+      continue;
+    }
+
+    const uint64_t next = texec_timer_wheel_next_expiration(&s->wheel);
+    s->sleep_until = next;
+    const unsigned int key = atomic_load_explicit(&s->wake_seq, memory_order_acquire);
+    mtx_unlock(&s->mtx);
+
+    if (next == UINT64_MAX) {
+      texec_futex_wait(&s->wake_seq, key);
+    } else {
+      const uint64_t wake_ns = s->origin_ns + next * TIMER_TICK_NS;
+      const uint64_t now_ns = texec_clock_now_ns();
+      if (wake_ns > now_ns) texec_futex_wait_timeout(&s->wake_seq, key, wake_ns - now_ns);
+    }
+
+    mtx_lock(&s->mtx);
+  }
+
+  // Closed: timers still waiting never run
+  texec_timer_wheel_entry_t* pending = texec_timer_wheel_take_all(&s->wheel);
+  for (texec_timer_wheel_entry_t* e = pending; e; e = e->next) timer_from_entry(e)->state = TIMER_FINISHED;
+  mtx_unlock(&s->mtx);
+
+  while (pending) {
+    texec_timer_t* t = timer_from_entry(pending);
+    pending = pending->next;
+    timer_finish(t, TEXEC_STATUS_CLOSED);
+  }
+  return 0;
+}
+
+static texec_status_t timer_service_create(texec_executor_t* ex, texec_timer_service_t** out_service) {
+  texec_timer_service_t* s = texec_allocate(ex->alloc, sizeof(*s), _Alignof(texec_timer_service_t));
+  if (!s) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  s->ex = ex;
+  s->alloc = ex->alloc;
+  atomic_init(&s->refcount, 1u);
+  texec_timer_wheel_init(&s->wheel);
+  s->origin_ns = texec_clock_now_ns();
+  s->sleep_until = UINT64_MAX;
+  atomic_init(&s->wake_seq, 0u);
+  s->closed = false;
+  s->joined = false;
+
+  if (mtx_init(&s->mtx, mtx_plain) != thrd_success) {
+    texec_free(s->alloc, s, sizeof(*s), _Alignof(texec_timer_service_t));
+    return TEXEC_STATUS_INTERNAL_ERROR;
+  }
+
+  if (thrd_create(&s->thread, timer_thread_main, s) != thrd_success) {
+    mtx_destroy(&s->mtx);
+    texec_free(s->alloc, s, sizeof(*s), _Alignof(texec_timer_service_t));
+    return TEXEC_STATUS_INTERNAL_ERROR;
+  }
+
+  *out_service = s;
+  return TEXEC_STATUS_OK;
+}
+
+static void timer_service_close(texec_timer_service_t* s) {
+  mtx_lock(&s->mtx);
+  s->closed = true;
+  mtx_unlock(&s->mtx);
+  timer_service_wake(s);
+}
+
+static void timer_service_join(texec_timer_service_t* s) {
+  mtx_lock(&s->mtx);
+  const bool join = !s->joined;
+  s->joined = true;
+  mtx_unlock(&s->mtx);
+
+  if (join) thrd_join(s->thread, NULL);
+}
+
+// Returns the executor's timer service, starting it on first use.
+static texec_status_t timer_service_get(texec_executor_t* ex, texec_timer_service_t** out_service) {
+  texec_timer_service_t* s = atomic_load_explicit(&ex->timers, memory_order_acquire);
+  if (s == &timer_service_closed) return TEXEC_STATUS_CLOSED;
+  if (s) {
+    *out_service = s;
+    return TEXEC_STATUS_OK;
+  }
+
+  texec_timer_service_t* created = NULL;
+  const texec_status_t st = timer_service_create(ex, &created);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  if (!atomic_compare_exchange_strong_explicit(&ex->timers, &s, created, memory_order_acq_rel, memory_order_acquire)) {
+    // Another thread started one first, or the executor was closed meanwhile
+    timer_service_close(created);
+    timer_service_join(created);
+    timer_service_release(created);
+    if (s == &timer_service_closed) return TEXEC_STATUS_CLOSED;
+  } else {
+    s = created;
+  }
+
+  *out_service = s;
+  return TEXEC_STATUS_OK;
+}
+
+static inline bool timer_copy_extension(const texec_schedule_info_t* info, texec_struct_type_t type, void* dst, size_t size) {
+  const void* src = texec_structure_find(info->header.next, type);
+  if (!src) return false;
+  memcpy(dst, src, size);
+  return true;
+}
+
+texec_status_t texec_executor_schedule(texec_executor_t* ex, const texec_schedule_info_t* info, texec_timer_t** out_timer) {
+  if (out_timer) *out_timer = NULL;
+  if (!ex || !info || info->header.type != TEXEC_STRUCT_TYPE_SCHEDULE_INFO || !info->task.run) {
+    return TEXEC_STATUS_INVALID_ARGUMENT;
+  }
+
+  const texec_submit_context_info_t* context = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_CONTEXT);
+  if (context && context->size && !context->data) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  texec_timer_service_t* s = NULL;
+  texec_status_t st = timer_service_get(ex, &s);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  texec_timer_t* t = texec_allocate(s->alloc, sizeof(*t), _Alignof(texec_timer_t));
+  if (!t) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  atomic_init(&t->refcount, out_timer ? 2u : 1u);
+  t->service = s;
+  t->cancelled = false;
+  t->period_ns = info->period_ns;
+  t->task = info->task;
+  t->context.heap = NULL;
+  // Every run of a periodic timer shares the one copy
+  if (context && !texec_context_copy_init(&t->context, s->alloc, context, &t->task.ctx)) {
+    texec_free(s->alloc, t, sizeof(*t), _Alignof(texec_timer_t));
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+  t->has_priority = timer_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_PRIORITY, &t->priority, sizeof(t->priority));
+  t->has_trace_context = timer_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_TRACE_CONTEXT, &t->trace_context, sizeof(t->trace_context));
+  t->has_node = timer_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_NODE, &t->node, sizeof(t->node));
+  t->has_cancel = timer_copy_extension(info, TEXEC_STRUCT_TYPE_SUBMIT_CANCEL, &t->cancel, sizeof(t->cancel));
+  if (t->has_cancel && texec_cancel_token_retain(t->cancel.token) != TEXEC_STATUS_OK) t->has_cancel = false;
+
+  const uint64_t now_ns = texec_clock_now_ns();
+  t->due_ns = info->delay_ns < UINT64_MAX - now_ns ? now_ns + info->delay_ns : UINT64_MAX;
+
+  atomic_fetch_add_explicit(&s->refcount, 1u, memory_order_relaxed);
+
+  mtx_lock(&s->mtx);
+  if (s->closed) {
+    mtx_unlock(&s->mtx);
+    if (t->has_cancel) texec_cancel_token_release(t->cancel.token);
+    texec_context_copy_release(&t->context, s->alloc);
+    texec_free(s->alloc, t, sizeof(*t), _Alignof(texec_timer_t));
+    timer_service_release(s);
+    return TEXEC_STATUS_CLOSED;
+  }
+  timer_arm_locked(s, t);
+  mtx_unlock(&s->mtx);
+
+  if (out_timer) *out_timer = t;
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_timer_cancel(texec_timer_t* t) {
+  if (!t) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  texec_timer_service_t* s = t->service;
+  mtx_lock(&s->mtx);
+  switch (t->state) {
+  case TIMER_ARMED:
+    texec_timer_wheel_remove(&s->wheel, &t->entry);
+    t->state = TIMER_FINISHED;
+    mtx_unlock(&s->mtx);
+    timer_finish(t, TEXEC_STATUS_OK);
+    return TEXEC_STATUS_OK;
+
+  case TIMER_RUNNING:
+    t->cancelled = true;
+    mtx_unlock(&s->mtx);
+    return TEXEC_STATUS_BUSY;
+
+  default:
+    mtx_unlock(&s->mtx);
+    return TEXEC_STATUS_CLOSED;
+  }
+}
+
+void texec_executor_close_timers(texec_executor_t* ex) {
+  texec_timer_service_t* s = NULL;
+  if (atomic_compare_exchange_strong_explicit(&ex->timers, &s, &timer_service_closed, memory_order_acq_rel, memory_order_acquire)) return;
+  if (timer_service_is_real(s)) timer_service_close(s);
+}
+
+void texec_executor_join_timers(texec_executor_t* ex) {
+  texec_executor_close_timers(ex);
+  texec_timer_service_t* s = atomic_load_explicit(&ex->timers, memory_order_acquire);
+  if (timer_service_is_real(s)) timer_service_join(s);
+}
+
+void texec_executor_release_timers(texec_executor_t* ex) {
+  texec_executor_join_timers(ex);
+  texec_timer_service_t* s = atomic_load_explicit(&ex->timers, memory_order_acquire);
+  if (timer_service_is_real(s)) timer_service_release(s);
+}
@@ -0,0 +1,171 @@
+#include "internal/timer_wheel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define TIMER_WHEEL_SLOT_BITS 6u
+#define TIMER_WHEEL_SLOT_MASK ((uint64_t)TEXEC_TIMER_WHEEL_SLOTS - 1)
+
+// Ticks the whole wheel spans; farther entries wait in the top level and are re-inserted when
+// their slot comes round.
+#define TIMER_WHEEL_MAX_SPAN ((UINT64_C(1) << (TIMER_WHEEL_SLOT_BITS * TEXEC_TIMER_WHEEL_LEVELS)) - 1)
+
+static inline unsigned int timer_wheel_highest_bit(uint64_t x) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse64(&index, x);
+  return (unsigned int)index;
+#else
+  return 63u - (unsigned int)__builtin_clzll(x);
+#endif
+}
+
+static inline unsigned int timer_wheel_lowest_bit(uint64_t x) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return (unsigned int)index;
+#else
+  return (unsigned int)__builtin_ctzll(x);
+#endif
+}
+
+static inline uint64_t timer_wheel_slot_range(unsigned int level) {
+  return UINT64_C(1) << (TIMER_WHEEL_SLOT_BITS * level);
+}
+
+static inline uint64_t timer_wheel_level_range(unsigned int level) {
+  return UINT64_C(1) << (TIMER_WHEEL_SLOT_BITS * (level + 1));
+}
+
+// The level is given by the highest bit in which `when` differs from `elapsed`: entries of level
+// L all fall in the current level L + 1 slot, so lower levels always expire first.
+static inline unsigned int timer_wheel_level_for(uint64_t elapsed, uint64_t when) {
+  uint64_t masked = (elapsed ^ when) | TIMER_WHEEL_SLOT_MASK;
+  if (masked >= TIMER_WHEEL_MAX_SPAN) masked = TIMER_WHEEL_MAX_SPAN - 1;
+  return timer_wheel_highest_bit(masked) / TIMER_WHEEL_SLOT_BITS;
+}
+
+void texec_timer_wheel_init(texec_timer_wheel_t* w) {
+  w->elapsed = 0;
+  w->count = 0;
+  for (unsigned int level = 0; level < TEXEC_TIMER_WHEEL_LEVELS; ++level) {
+    w->occupied[level] = 0;
+    for (unsigned int slot = 0; slot < TEXEC_TIMER_WHEEL_SLOTS; ++slot) w->slots[level][slot] = NULL;
+  }
+}
+
+void texec_timer_wheel_insert(texec_timer_wheel_t* w, texec_timer_wheel_entry_t* e) {
+  const unsigned int level = timer_wheel_level_for(w->elapsed, e->when);
+  const unsigned int slot = (unsigned int)((e->when >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK);
+
+  texec_timer_wheel_entry_t* head = w->slots[level][slot];
+  e->level = level;
+  e->slot = slot;
+  e->prev = NULL;
+  e->next = head;
+  if (head) head->prev = e;
+  w->slots[level][slot] = e;
+  w->occupied[level] |= UINT64_C(1) << slot;
+  ++w->count;
+}
+
+void texec_timer_wheel_remove(texec_timer_wheel_t* w, texec_timer_wheel_entry_t* e) {
+  if (e->prev) {
+    e->prev->next = e->next;
+  } else {
+    w->slots[e->level][e->slot] = e->next;
+    if (!e->next) w->occupied[e->level] &= ~(UINT64_C(1) << e->slot);
+  }
+  if (e->next) e->next->prev = e->prev;
+  e->prev = NULL;
+  e->next = NULL;
+  --w->count;
+}
+
+// Finds the next occupied slot, in due order, of the lowest non-empty level.
+static bool timer_wheel_next_slot(const texec_timer_wheel_t* w, unsigned int* out_level, unsigned int* out_slot, uint64_t* out_deadline) {
+  for (unsigned int level = 0; level < TEXEC_TIMER_WHEEL_LEVELS; ++level) {
+    const uint64_t occupied = w->occupied[level];
+    if (!occupied) continue;
+
+    const uint64_t slot_range = timer_wheel_slot_range(level);
+    const uint64_t level_range = timer_wheel_level_range(level);
+    const unsigned int now_slot = (unsigned int)((w->elapsed / slot_range) & TIMER_WHEEL_SLOT_MASK);
+
+    // Scan from the slot after the current one: only the top level can have its current slot
+    // occupied, by entries beyond the wheel's span that are due a full turn later at the earliest
+    const unsigned int start = (now_slot + 1u) & (unsigned int)TIMER_WHEEL_SLOT_MASK;
+    const uint64_t rotated = start ? (occupied >> start) | (occupied << (64u - start)) : occupied;
+    const unsigned int slot = (timer_wheel_lowest_bit(rotated) + start) & (unsigned int)TIMER_WHEEL_SLOT_MASK;
+
+    uint64_t deadline = (w->elapsed & ~(level_range - 1)) + slot * slot_range;
+    // Only entries beyond the wheel's span sit "behind" the current top level position
+    if (deadline <= w->elapsed) deadline += level_range;
+
+    *out_level = level;
+    *out_slot = slot;
+    *out_deadline = deadline;
+    return true;
+  }
+  return false;
+}
+
+uint64_t texec_timer_wheel_next_expiration(const texec_timer_wheel_t* w) {
+  unsigned int level, slot;
+  uint64_t deadline;
+  return timer_wheel_next_slot(w, &level, &slot, &deadline) ? deadline : UINT64_MAX;
+}
+
+texec_timer_wheel_entry_t* texec_timer_wheel_advance(texec_timer_wheel_t* w, uint64_t now) {
+  texec_timer_wheel_entry_t* due = NULL;
+
+  unsigned int level, slot;
+  uint64_t deadline;
+  while (timer_wheel_next_slot(w, &level, &slot, &deadline) && deadline <= now) {
+    w->elapsed = deadline;
+
+    texec_timer_wheel_entry_t* e = w->slots[level][slot];
+    w->slots[level][slot] = NULL;
+    w->occupied[level] &= ~(UINT64_C(1) << slot);
+
+    while (e) {
+      texec_timer_wheel_entry_t* next = e->next;
+      --w->count;
+      if (e->when <= w->elapsed) {
+        e->prev = NULL;
+        e->next = due;
+        due = e;
+      } else {
+        texec_timer_wheel_insert(w, e); // cascades to a lower level
+      }
+      e = next;
+    }
+  }
+
+  if (now > w->elapsed) w->elapsed = now;
+  return due;
+}
+
+texec_timer_wheel_entry_t* texec_timer_wheel_take_all(texec_timer_wheel_t* w) {
+  texec_timer_wheel_entry_t* all = NULL;
+  for (unsigned int level = 0; level < TEXEC_TIMER_WHEEL_LEVELS; ++level) {
+    while (w->occupied[level]) {
+      const unsigned int slot = timer_wheel_lowest_bit(w->occupied[level]);
+      texec_timer_wheel_entry_t* e = w->slots[level][slot];
+      w->slots[level][slot] = NULL;
+      w->occupied[level] &= ~(UINT64_C(1) << slot);
+
+      while (e) {
+        texec_timer_wheel_entry_t* next = e->next;
+        e->prev = NULL;
+        e->next = all;
+        all = e;
+        e = next;
+      }
+    }
+  }
+  w->count = 0;
+  return all;
+}
@@ -0,0 +1,213 @@
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include "internal/topology.h"
+
+#if defined(__linux__)
+
+#include <dirent.h>
+#include <limits.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+size_t texec_topology_available_cpus(unsigned int* out_cpus, size_t capacity) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) return 0;
+
+  size_t count = 0;
+  for (unsigned int cpu = 0; cpu < CPU_SETSIZE && count < capacity; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) out_cpus[count++] = cpu;
+  }
+  return count;
+}
+
+static size_t topology_quota_to_cpus(long long quota, long long period) {
+  if (quota <= 0 || period <= 0) return 0;
+  return (size_t)((quota + period - 1) / period);
+}
+
+// cgroup v2: "<quota> <period>" or "max <period>"
+static size_t topology_read_cpu_max(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) return 0;
+
+  char quota[32] = {0};
+  long long period = 0;
+  size_t cpus = 0;
+  if (fscanf(f, "%31s %lld", quota, &period) == 2 && strcmp(quota, "max") != 0) {
+    long long q = 0;
+    if (sscanf(quota, "%lld", &q) == 1) cpus = topology_quota_to_cpus(q, period);
+  }
+
+  fclose(f);
+  return cpus;
+}
+
+static long long topology_read_number(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) return -1;
+
+  long long value = -1;
+  if (fscanf(f, "%lld", &value) != 1) value = -1;
+  fclose(f);
+  return value;
+}
+
+// Path of the calling process in the cgroup v2 hierarchy ("0::<path>"), or "" if not found.
+// Returns false if the path does not fit in `capacity`.
+static bool topology_cgroup2_path(char* out, size_t capacity) {
+  out[0] = '\0';
+
+  FILE* f = fopen("/proc/self/cgroup", "r");
+  if (!f) return true;
+
+  char line[PATH_MAX + 8]; // "0::", the path and the newline
+  bool fits = true;
+  bool line_start = true; // fgets stops mid-line on longer ones
+  while (fgets(line, sizeof(line), f)) {
+    const size_t len = strcspn(line, "\n");
+    const bool complete = line[len] == '\n' || feof(f);
+    const bool match = line_start && strncmp(line, "0::", 3) == 0;
+    line_start = complete;
+    if (!match) continue;
+
+    const size_t path_len = len - 3;
+    fits = complete && path_len < capacity;
+    if (fits) {
+      memcpy(out, line + 3, path_len);
+      out[path_len] = '\0';
+    }
+    break;
+  }
+  fclose(f);
+  return fits;
+}
+
+size_t texec_topology_cpu_quota(void) {
+  // A truncated path would read another cgroup's limit: report no quota instead
+  char cgroup[PATH_MAX];
+  if (!topology_cgroup2_path(cgroup, sizeof(cgroup))) return 0;
+
+  char path[PATH_MAX + 32];
+  const int n = snprintf(path, sizeof(path), "/sys/fs/cgroup%s/cpu.max", cgroup);
+  if (n < 0 || (size_t)n >= sizeof(path)) return 0;
+  size_t cpus = topology_read_cpu_max(path);
+  if (cpus) return cpus;
+
+  cpus = topology_read_cpu_max("/sys/fs/cgroup/cpu.max");
+  if (cpus) return cpus;
+
+  // cgroup v1
+  return topology_quota_to_cpus(topology_read_number("/sys/fs/cgroup/cpu/cpu.cfs_quota_us"),
+                                topology_read_number("/sys/fs/cgroup/cpu/cpu.cfs_period_us"));
+}
+
+unsigned int texec_topology_cpu_node(unsigned int cpu) {
+  // sysfs links each CPU to its node as /sys/devices/system/cpu/cpuN/nodeM
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu);
+
+  DIR* dir = opendir(path);
+  if (!dir) return 0;
+
+  unsigned int node = 0;
+  const struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (sscanf(entry->d_name, "node%u", &node) == 1) break;
+    node = 0;
+  }
+  closedir(dir);
+  return node;
+}
+
+bool texec_topology_current_cpu(unsigned int* out_cpu) {
+  const int cpu = sched_getcpu();
+  if (cpu < 0) return false;
+  *out_cpu = (unsigned int)cpu;
+  return true;
+}
+
+bool texec_topology_pin_current_thread(const unsigned int* cpus, size_t count) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (size_t i = 0; i < count; ++i) {
+    if (cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+  }
+  return CPU_COUNT(&set) != 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+#elif defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+// Only processor group 0 (the first 64 logical processors) is considered.
+
+size_t texec_topology_available_cpus(unsigned int* out_cpus, size_t capacity) {
+  DWORD_PTR process_mask = 0;
+  DWORD_PTR system_mask = 0;
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) return 0;
+
+  size_t count = 0;
+  for (unsigned int cpu = 0; cpu < sizeof(DWORD_PTR) * 8 && count < capacity; ++cpu) {
+    if (process_mask & ((DWORD_PTR)1 << cpu)) out_cpus[count++] = cpu;
+  }
+  return count;
+}
+
+size_t texec_topology_cpu_quota(void) {
+  return 0;
+}
+
+unsigned int texec_topology_cpu_node(unsigned int cpu) {
+  UCHAR node = 0;
+  if (cpu > 0xFF || !GetNumaProcessorNode((UCHAR)cpu, &node) || node == 0xFF) return 0;
+  return node;
+}
+
+bool texec_topology_current_cpu(unsigned int* out_cpu) {
+  *out_cpu = (unsigned int)GetCurrentProcessorNumber();
+  return true;
+}
+
+bool texec_topology_pin_current_thread(const unsigned int* cpus, size_t count) {
+  DWORD_PTR mask = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (cpus[i] < sizeof(DWORD_PTR) * 8) mask |= (DWORD_PTR)1 << cpus[i];
+  }
+  return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+#else
+
+size_t texec_topology_available_cpus(unsigned int* out_cpus, size_t capacity) {
+  (void)out_cpus;
+  (void)capacity;
+  return 0;
+}
+
+size_t texec_topology_cpu_quota(void) {
+  return 0;
+}
+
+unsigned int texec_topology_cpu_node(unsigned int cpu) {
+  (void)cpu;
+  return 0;
+}
+
+bool texec_topology_current_cpu(unsigned int* out_cpu) {
+  (void)out_cpu;
+  return false;
+}
+
+bool texec_topology_pin_current_thread(const unsigned int* cpus, size_t count) {
+  (void)cpus;
+  (void)count;
+  return false;
+}
+
+#endif
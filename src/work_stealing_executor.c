@@ -0,0 +1,698 @@
+#include "internal/executor.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <threads.h>
+
+#include "texec/queue.h"
+#include "texec/task_group.h"
+#include "internal/cache_line.h"
+#include "internal/event_count.h"
+#include "internal/help.h"
+#include "internal/placement.h"
+#include "internal/task_handle.h"
+#include "internal/topology.h"
+#include "internal/worker_metrics.h"
+#include "internal/ws_deque.h"
+
+struct work_stealing_executor;
+
+typedef struct ws_worker {
+  texec_ws_deque_t deque;
+  texec_worker_counters_t counters;
+  struct work_stealing_executor* ex;
+  size_t index;
+  uint64_t rng;
+  const unsigned int* cpus; // CPUs the worker is restricted to, from the executor's placement
+  size_t cpu_count;
+} ws_worker_t;
+
+typedef struct work_stealing_executor {
+  texec_executor_t base;
+  mtx_t mtx;
+  texec_queue_t* injector; // submissions from outside the pool
+  ws_worker_t* workers;
+  thrd_t* threads;
+  size_t thread_count;
+  texec_backpressure_policy_t backpressure;
+  texec_event_count_t idle;
+  texec_placement_t placement; // run queues are per worker, so numa_queues does not apply
+
+  // Updated by submitters on the slow path only
+  atomic_uint_least64_t rejected_count;
+  atomic_uint_least64_t caller_runs_count;
+} work_stealing_executor_t;
+
+// The worker running on the current thread, if any (of any work-stealing executor).
+static _Thread_local ws_worker_t* ws_current_worker = NULL;
+
+static inline bool ws_is_work_stealing(const texec_executor_t* ex) {
+  return ex && ex->kind == TEXEC_EXECUTOR_KIND_WORK_STEALING;
+}
+
+static inline work_stealing_executor_t* ws_from_base(texec_executor_t* ex) {
+  if (!ws_is_work_stealing(ex)) {
+    return NULL;
+  }
+  return (work_stealing_executor_t*)ex;
+}
+
+static inline const work_stealing_executor_t* ws_from_const_base(const texec_executor_t* ex) {
+  if (!ws_is_work_stealing(ex)) {
+    return NULL;
+  }
+  return (const work_stealing_executor_t*)ex;
+}
+
+static inline ws_worker_t* ws_local_worker(work_stealing_executor_t* ex) {
+  ws_worker_t* w = ws_current_worker;
+  return (w && w->ex == ex) ? w : NULL;
+}
+
+static texec_executor_state_t ws_get_state(work_stealing_executor_t* ex) {
+  mtx_lock(&ex->mtx);
+  const texec_executor_state_t state = ex->base.state;
+  mtx_unlock(&ex->mtx);
+  return state;
+}
+
+static void ws_free(work_stealing_executor_t* ex) {
+  texec_free(ex->base.alloc, ex, sizeof(*ex), _Alignof(work_stealing_executor_t));
+}
+
+static void ws_free_workers(work_stealing_executor_t* ex, size_t initialized_count) {
+  for (size_t i = 0; i < initialized_count; ++i) {
+    texec_ws_deque_destroy(&ex->workers[i].deque);
+  }
+  texec_free(ex->base.alloc, ex->workers, ex->thread_count * sizeof(ws_worker_t), _Alignof(ws_worker_t));
+  ex->workers = NULL;
+}
+
+static texec_status_t ws_destroy_unchecked(work_stealing_executor_t* ex) {
+  if (ex->injector) {
+    texec_status_t st = texec_queue_destroy(ex->injector);
+    if (st != TEXEC_STATUS_OK) return st;
+  }
+
+  if (ex->workers) {
+    ws_free_workers(ex, ex->thread_count);
+  }
+
+  if (ex->threads) {
+    texec_free(ex->base.alloc, ex->threads, ex->thread_count * sizeof(thrd_t), _Alignof(thrd_t));
+  }
+
+  texec_placement_destroy(&ex->placement);
+  mtx_destroy(&ex->mtx);
+
+  texec_executor_release_pools(&ex->base);
+
+  ws_free(ex);
+
+  return TEXEC_STATUS_OK;
+}
+
+static inline uint64_t ws_next_random(ws_worker_t* w) {
+  // xorshift64
+  uint64_t x = w->rng;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  w->rng = x;
+  return x;
+}
+
+static bool ws_steal(ws_worker_t* w, texec_work_item_t** out_wi) {
+  work_stealing_executor_t* ex = w->ex;
+  const size_t n = ex->thread_count;
+  if (n < 2) return false;
+
+  const size_t start = (size_t)(ws_next_random(w) % n);
+  for (size_t k = 0; k < n; ++k) {
+    const size_t victim = (start + k) % n;
+    if (victim == w->index) continue;
+
+    uintptr_t item = 0;
+    if (texec_ws_deque_steal(&ex->workers[victim].deque, &item)) {
+      texec_worker_counter_add(&w->counters.steals, 1);
+      *out_wi = (texec_work_item_t*)item;
+      return true;
+    }
+  }
+  return false;
+}
+
+typedef enum ws_find_result {
+  WS_FOUND,
+  WS_EMPTY,
+  WS_DRAINED, // injector closed and empty, nothing to steal
+} ws_find_result_t;
+
+static ws_find_result_t ws_find_work(ws_worker_t* w, texec_work_item_t** out_wi) {
+  uintptr_t item = 0;
+  if (texec_ws_deque_pop(&w->deque, &item)) {
+    *out_wi = (texec_work_item_t*)item;
+    return WS_FOUND;
+  }
+
+  const texec_status_t st = texec_queue_try_pop(w->ex->injector, &item);
+  if (st == TEXEC_STATUS_OK) {
+    *out_wi = (texec_work_item_t*)item;
+    return WS_FOUND;
+  }
+
+  if (ws_steal(w, out_wi)) return WS_FOUND;
+
+  // Only the owner pushes to its deque, so once ours is empty and the injector
+  // is closed nothing new can show up for this worker.
+  return (st == TEXEC_STATUS_CLOSED) ? WS_DRAINED : WS_EMPTY;
+}
+
+// Runs one task while a task of this worker is blocked in a wait. Its own deque comes first, so
+// the newest spawn, typically the one being waited for, runs before anything stolen.
+static bool ws_help_run_one(void* arg) {
+  ws_worker_t* w = (ws_worker_t*)arg;
+  texec_work_item_t* wi = NULL;
+  if (ws_find_work(w, &wi) != WS_FOUND) return false;
+
+  texec_executor_consume_work_item(&w->ex->base, wi);
+  texec_worker_counter_add(&w->counters.tasks_executed, 1);
+  return true;
+}
+
+static int ws_worker_main(void* arg) {
+  ws_worker_t* w = (ws_worker_t*)arg;
+  work_stealing_executor_t* ex = w->ex;
+  ws_current_worker = w;
+
+  const texec_helper_t helper = {ws_help_run_one, w};
+  texec_help_install(&helper);
+
+  if (w->cpu_count) {
+    texec_topology_pin_current_thread(w->cpus, w->cpu_count); // best effort
+  }
+
+  for (;;) {
+    texec_work_item_t* wi = NULL;
+    ws_find_result_t r = ws_find_work(w, &wi);
+
+    if (r == WS_EMPTY) {
+      const unsigned int key = texec_event_count_prepare_wait(&ex->idle);
+      r = ws_find_work(w, &wi);
+      if (r == WS_EMPTY) {
+        texec_worker_counters_transition(&w->counters, true);
+        texec_event_count_wait(&ex->idle, key);
+        texec_worker_counters_transition(&w->counters, false);
+        continue;
+      }
+      texec_event_count_cancel_wait(&ex->idle);
+    }
+
+    if (r == WS_DRAINED) break;
+
+    texec_executor_consume_work_item(&ex->base, wi);
+    texec_worker_counter_add(&w->counters.tasks_executed, 1);
+  }
+
+  texec_help_install(NULL);
+  ws_current_worker = NULL;
+  return 0;
+}
+
+static texec_status_t ws_start_workers(work_stealing_executor_t* ex) {
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    if (thrd_create(&ex->threads[i], &ws_worker_main, &ex->workers[i]) != thrd_success) {
+      // Best effort: shut down already started threads
+      texec_queue_close(ex->injector);
+      texec_event_count_notify_all(&ex->idle);
+      for (size_t j = 0; j < i; ++j) {
+        thrd_join(ex->threads[j], NULL);
+      }
+      return TEXEC_STATUS_INTERNAL_ERROR;
+    }
+  }
+  return TEXEC_STATUS_OK;
+}
+
+static texec_status_t ws_push_injector(work_stealing_executor_t* ex, texec_work_item_t* wi, texec_backpressure_policy_t backpressure) {
+  texec_status_t st = TEXEC_STATUS_INTERNAL_ERROR;
+
+  switch (backpressure) {
+  case TEXEC_BACKPRESSURE_REJECT:
+    st = texec_queue_try_push_ptr(ex->injector, wi);
+    break;
+
+  case TEXEC_BACKPRESSURE_BLOCK:
+    st = texec_queue_push_ptr(ex->injector, wi);
+    break;
+
+  case TEXEC_BACKPRESSURE_CALLER_RUNS:
+    st = texec_queue_try_push_ptr(ex->injector, wi);
+    if (st == TEXEC_STATUS_REJECTED) {
+      atomic_fetch_add_explicit(&ex->caller_runs_count, 1, memory_order_relaxed);
+      texec_executor_consume_work_item(&ex->base, wi);
+      return TEXEC_STATUS_OK;
+    }
+    break;
+
+  default:
+    assert(false);
+    break;
+  }
+
+  if (st == TEXEC_STATUS_OK) {
+    texec_event_count_notify_one(&ex->idle);
+  } else if (st == TEXEC_STATUS_REJECTED) {
+    atomic_fetch_add_explicit(&ex->rejected_count, 1, memory_order_relaxed);
+  }
+  return st;
+}
+
+static inline texec_backpressure_policy_t ws_resolve_backpressure(const work_stealing_executor_t* ex, const texec_submit_info_t* info) {
+  const texec_submit_backpressure_info_t* bpi = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_BACKPRESSURE);
+  return (bpi ? bpi->backpressure : ex->backpressure);
+}
+
+static inline const void* ws_resolve_trace_context(const texec_submit_info_t* info) {
+  const texec_submit_trace_context_info_t* tci = texec_structure_find(info->header.next, TEXEC_STRUCT_TYPE_SUBMIT_TRACE_CONTEXT);
+  return tci ? tci->trace_context : NULL;
+}
+
+static texec_status_t ws_dispatch_work_item(work_stealing_executor_t* ex, texec_work_item_t* wi, texec_backpressure_policy_t backpressure);
+
+// `h` may be NULL for detached submissions; `group`, if any, counts the task. The reference to
+// `h` passed in belongs to the work item, and is released if the submit fails.
+static texec_status_t ws_submit_with_handle(work_stealing_executor_t* ex,
+                                            texec_task_t task,
+                                            const texec_submit_context_info_t* context,
+                                            const void* trace_context,
+                                            texec_cancel_token_t* cancel,
+                                            texec_backpressure_policy_t backpressure,
+                                            texec_task_handle_t* h,
+                                            texec_task_group_t* group) {
+  if (!ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (ws_get_state(ex) != TEXEC_EXECUTOR_STATE_RUNNING) {
+    texec_task_handle_release(h);
+    return TEXEC_STATUS_CLOSED;
+  }
+
+  if (group) {
+    texec_status_t st = texec_task_group_enter(group, 1);
+    if (st != TEXEC_STATUS_OK) {
+      texec_task_handle_release(h);
+      return st;
+    }
+  }
+
+  texec_work_item_t* wi = texec_executor_allocate_work_item(&ex->base);
+  if (!wi) {
+    if (group) texec_task_group_leave(group, 1);
+    texec_task_handle_release(h);
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+
+  wi->task = task;
+  wi->handle = h;
+  wi->group = group;
+  wi->trace_context = trace_context;
+  texec_work_item_set_cancel_token(wi, cancel);
+
+  if (context && !texec_work_item_copy_context(wi, ex->base.alloc, context)) {
+    texec_work_item_destroy(wi, ex->base.alloc); // releases `h` and leaves `group`
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+
+  return ws_dispatch_work_item(ex, wi, backpressure);
+}
+
+// Queues `wi`, destroying it if it could not be enqueued.
+static texec_status_t ws_dispatch_work_item(work_stealing_executor_t* ex, texec_work_item_t* wi, texec_backpressure_policy_t backpressure) {
+  // Work spawned by our own workers stays on their deque; everything else
+  // (and local overflow) goes through the bounded injector.
+  ws_worker_t* w = ws_local_worker(ex);
+  if (w && texec_ws_deque_push(&w->deque, (uintptr_t)wi)) {
+    texec_event_count_notify_one(&ex->idle);
+    return TEXEC_STATUS_OK;
+  }
+
+  texec_status_t st = ws_push_injector(ex, wi, backpressure);
+  if (st != TEXEC_STATUS_OK) {
+    texec_work_item_destroy(wi, ex->base.alloc);
+  }
+
+  return st;
+}
+
+static texec_executor_state_t ws_close(work_stealing_executor_t* ex) {
+  mtx_lock(&ex->mtx);
+  const texec_executor_state_t original_state = ex->base.state;
+  if (original_state == TEXEC_EXECUTOR_STATE_RUNNING) {
+    ex->base.state = TEXEC_EXECUTOR_STATE_CLOSING;
+    texec_queue_close(ex->injector);
+  }
+  mtx_unlock(&ex->mtx);
+  texec_event_count_notify_all(&ex->idle);
+  return original_state;
+}
+
+static void ws_join(work_stealing_executor_t* ex) {
+  if (ws_close(ex) == TEXEC_EXECUTOR_STATE_CLOSED) return;
+
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    thrd_join(ex->threads[i], NULL);
+  }
+
+  mtx_lock(&ex->mtx);
+  ex->base.state = TEXEC_EXECUTOR_STATE_CLOSED;
+  mtx_unlock(&ex->mtx);
+}
+
+static texec_status_t ws_vtbl_submit(texec_executor_t* ex, const texec_submit_info_t* info, texec_task_handle_t** out_handle) {
+  if (out_handle) *out_handle = NULL;
+
+  work_stealing_executor_t* ws_ex = ws_from_base(ex);
+  if (!ws_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (!info || info->header.type != TEXEC_STRUCT_TYPE_SUBMIT_INFO) {
+    return TEXEC_STATUS_INVALID_ARGUMENT;
+  }
+
+  if (!info->task.run) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  const texec_backpressure_policy_t backpressure = ws_resolve_backpressure(ws_ex, info);
+  const void* trace_context = ws_resolve_trace_context(info);
+  texec_task_group_t* group = texec_executor_find_submit_group(info);
+  texec_cancel_token_t* cancel = texec_executor_find_submit_cancel_token(info, group);
+  const texec_submit_context_info_t* context = texec_executor_find_submit_context(info);
+
+  if (!out_handle) {
+    // Detached: only the work item is built, completion is observed through task.on_complete
+    return ws_submit_with_handle(ws_ex, info->task, context, trace_context, cancel, backpressure, NULL, group);
+  }
+
+  texec_task_handle_t* h = texec_executor_create_submit_handle(&ws_ex->base, info);
+  if (!h) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  if (texec_task_handle_retain(h) != TEXEC_STATUS_OK) {
+    texec_task_handle_destroy(h);
+    return TEXEC_STATUS_INTERNAL_ERROR;
+  }
+
+  texec_status_t st = ws_submit_with_handle(ws_ex, info->task, context, trace_context, cancel, backpressure, h, group);
+  if (st != TEXEC_STATUS_OK) {
+    texec_task_handle_release(h);
+    return st;
+  }
+
+  *out_handle = h;
+  return st;
+}
+
+static texec_status_t ws_vtbl_submit_intrusive(texec_executor_t* ex, const texec_submit_intrusive_info_t* info) {
+  work_stealing_executor_t* ws_ex = ws_from_base(ex);
+  if (!ws_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  // The resolver only looks at the extension chain
+  const texec_submit_info_t chain = {
+    .header = {TEXEC_STRUCT_TYPE_SUBMIT_INFO, info->header.next},
+    .task = info->task->task,
+  };
+
+  if (ws_get_state(ws_ex) != TEXEC_EXECUTOR_STATE_RUNNING) return TEXEC_STATUS_CLOSED;
+
+  return ws_dispatch_work_item(ws_ex, texec_work_item_from_intrusive(info->task), ws_resolve_backpressure(ws_ex, &chain));
+}
+
+static texec_status_t ws_vtbl_submit_many(texec_executor_t* ex, const texec_submit_info_t* infos, size_t count, texec_task_group_t** out_group) {
+  if (!out_group) return TEXEC_STATUS_INVALID_ARGUMENT;
+  *out_group = NULL;
+
+  work_stealing_executor_t* ws_ex = ws_from_base(ex);
+  if (!ws_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  if (count && !infos) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  for (size_t i = 0; i < count; ++i) {
+    if (infos[i].header.type != TEXEC_STRUCT_TYPE_SUBMIT_INFO || !infos[i].task.run) {
+      return TEXEC_STATUS_INVALID_ARGUMENT;
+    }
+  }
+
+  // Tasks are only counted by the group, no per-task handles
+  const texec_task_group_create_info_t gi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_TASK_GROUP_CREATE_INFO, .next = NULL},
+    .capacity = 0,
+  };
+
+  texec_task_group_t* g = NULL;
+  texec_status_t st = texec_task_group_create(&gi, ex->alloc, &g);
+  if (st != TEXEC_STATUS_OK) return st;
+
+  for (size_t i = 0; i < count; ++i) {
+    const texec_backpressure_policy_t backpressure = ws_resolve_backpressure(ws_ex, &infos[i]);
+    texec_cancel_token_t* cancel = texec_executor_find_submit_cancel_token(&infos[i], g);
+    st = ws_submit_with_handle(ws_ex, infos[i].task, texec_executor_find_submit_context(&infos[i]), ws_resolve_trace_context(&infos[i]), cancel, backpressure, NULL, g);
+    if (st != TEXEC_STATUS_OK) break;
+  }
+
+  if (st != TEXEC_STATUS_OK) {
+    // Already queued tasks keep running; the group is freed once they finish
+    texec_task_group_destroy(g);
+  } else {
+    *out_group = g;
+  }
+  return st;
+}
+
+static void ws_vtbl_close(texec_executor_t* ex) {
+  work_stealing_executor_t* ws_ex = ws_from_base(ex);
+  if (!ws_ex) return;
+  ws_close(ws_ex);
+}
+
+static void ws_vtbl_join(texec_executor_t* ex) {
+  work_stealing_executor_t* ws_ex = ws_from_base(ex);
+  if (!ws_ex) return;
+  ws_join(ws_ex);
+}
+
+static texec_status_t ws_vtbl_destroy(texec_executor_t* ex) {
+  work_stealing_executor_t* ws_ex = ws_from_base(ex);
+  if (!ws_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+  if (ws_get_state(ws_ex) != TEXEC_EXECUTOR_STATE_CLOSED) return TEXEC_STATUS_BUSY;
+  texec_executor_release_timers(ex);
+  return ws_destroy_unchecked(ws_ex);
+}
+
+static void ws_snapshot_worker(ws_worker_t* w, uint64_t now_ns, texec_worker_metrics_t* out) {
+  texec_worker_counters_snapshot(&w->counters, now_ns, out);
+  out->queue_depth = texec_ws_deque_size(&w->deque);
+}
+
+static void ws_query_worker_metrics(const work_stealing_executor_t* ex, texec_worker_metrics_t* out) {
+  const uint64_t now = texec_clock_now_ns();
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    ws_snapshot_worker(&ex->workers[i], now, &out[i]);
+  }
+}
+
+static void ws_query_metrics(const work_stealing_executor_t* ex, texec_executor_metrics_t* out) {
+  *out = (texec_executor_metrics_t){0};
+
+  const uint64_t now = texec_clock_now_ns();
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    texec_worker_metrics_t w;
+    ws_snapshot_worker(&ex->workers[i], now, &w);
+    texec_executor_metrics_accumulate(out, &w);
+  }
+
+  out->queue_depth += texec_queue_size(ex->injector);
+  out->rejected_submits = atomic_load_explicit(&ex->rejected_count, memory_order_relaxed);
+  out->caller_runs = atomic_load_explicit(&ex->caller_runs_count, memory_order_relaxed);
+}
+
+static texec_status_t ws_vtbl_query(const texec_executor_t* ex, texec_executor_capability_t cap, void* out_value) {
+  if (!out_value) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  const work_stealing_executor_t* ws_ex = ws_from_const_base(ex);
+  if (!ws_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  switch (cap) {
+  case TEXEC_EXECUTOR_CAPABILITY_WORKER_COUNT:
+    *(size_t*)out_value = ws_ex->thread_count;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_PRIORITY:
+    *(bool*)out_value = false;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_DEADLINE:
+    *(bool*)out_value = false;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_SUPPORTS_TRACING:
+    *(bool*)out_value = true;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_EXPIRED_COUNT:
+    *(uint64_t*)out_value = 0;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_METRICS:
+    ws_query_metrics(ws_ex, (texec_executor_metrics_t*)out_value);
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_WORKER_METRICS:
+    ws_query_worker_metrics(ws_ex, (texec_worker_metrics_t*)out_value);
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_LIVE_WORKER_COUNT:
+    *(size_t*)out_value = ws_ex->thread_count;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_NODE_COUNT:
+    *(size_t*)out_value = 1;
+    return TEXEC_STATUS_OK;
+
+  case TEXEC_EXECUTOR_CAPABILITY_IDLE_WORKER_COUNT: {
+    size_t idle = 0;
+    for (size_t i = 0; i < ws_ex->thread_count; ++i) {
+      idle += atomic_load_explicit(&ws_ex->workers[i].counters.parked, memory_order_relaxed);
+    }
+    *(size_t*)out_value = idle;
+    return TEXEC_STATUS_OK;
+  }
+
+  default:
+    break;
+  }
+
+  return TEXEC_STATUS_INVALID_ARGUMENT;
+}
+
+// Each deque is initialized from the CPUs of its worker's node, so that first-touch page
+// placement puts it in that node's memory.
+static texec_status_t ws_init_workers(work_stealing_executor_t* ex, size_t deque_capacity) {
+  for (size_t i = 0; i < ex->thread_count; ++i) {
+    ws_worker_t* w = &ex->workers[i];
+    texec_placement_enter_group(&ex->placement, texec_placement_worker_group(&ex->placement, i));
+    texec_status_t st = texec_ws_deque_init(&w->deque, deque_capacity, ex->base.alloc);
+    if (st != TEXEC_STATUS_OK) {
+      texec_placement_leave_group(&ex->placement);
+      ws_free_workers(ex, i);
+      return st;
+    }
+    texec_placement_worker_cpus(&ex->placement, i, &w->cpus, &w->cpu_count);
+    w->ex = ex;
+    w->index = i;
+    w->rng = 0x9E3779B97F4A7C15ull * (uint64_t)(i + 1);
+    texec_worker_counters_init(&w->counters);
+  }
+  texec_placement_leave_group(&ex->placement);
+  return TEXEC_STATUS_OK;
+}
+
+texec_status_t texec_executor_create_work_stealing(const texec_thread_pool_executor_config_t* cfg, texec_executor_t** out_ex) {
+  if (!out_ex) return TEXEC_STATUS_INVALID_ARGUMENT;
+  *out_ex = NULL;
+
+  if (!cfg) return TEXEC_STATUS_INVALID_ARGUMENT;
+
+  work_stealing_executor_t* ws_ex = texec_allocate(cfg->alloc, sizeof(*ws_ex), _Alignof(work_stealing_executor_t));
+  if (!ws_ex) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  static const texec_executor_vtable_t vtbl_instance = {
+    .submit = ws_vtbl_submit,
+    .submit_intrusive = ws_vtbl_submit_intrusive,
+    .submit_many = ws_vtbl_submit_many,
+    .close = ws_vtbl_close,
+    .join = ws_vtbl_join,
+    .destroy = ws_vtbl_destroy,
+    .query = ws_vtbl_query,
+  };
+
+  ws_ex->base.vtbl = &vtbl_instance;
+  ws_ex->base.alloc = cfg->alloc;
+  ws_ex->base.diag = cfg->diag;
+  ws_ex->base.work_item_pool = NULL;
+  ws_ex->base.handle_pool = NULL;
+  atomic_init(&ws_ex->base.timers, NULL);
+  ws_ex->base.kind = TEXEC_EXECUTOR_KIND_WORK_STEALING;
+  ws_ex->base.state = TEXEC_EXECUTOR_STATE_RUNNING;
+  ws_ex->injector = NULL;
+  ws_ex->workers = NULL;
+  ws_ex->threads = NULL;
+  ws_ex->thread_count = 0;
+  ws_ex->backpressure = cfg->backpressure;
+  ws_ex->placement = (texec_placement_t){.alloc = cfg->alloc};
+  atomic_init(&ws_ex->rejected_count, 0);
+  atomic_init(&ws_ex->caller_runs_count, 0);
+  texec_event_count_init(&ws_ex->idle);
+
+  if (mtx_init(&ws_ex->mtx, mtx_plain) != thrd_success) {
+    ws_free(ws_ex);
+    return TEXEC_STATUS_INTERNAL_ERROR;
+  }
+
+  texec_status_t st = texec_executor_init_pools(&ws_ex->base, &cfg->pool);
+  if (st != TEXEC_STATUS_OK) {
+    mtx_destroy(&ws_ex->mtx);
+    ws_free(ws_ex);
+    return st;
+  }
+
+  st = texec_placement_init(&ws_ex->placement, cfg->affinity, ws_ex->base.alloc);
+  if (st != TEXEC_STATUS_OK) {
+    ws_destroy_unchecked(ws_ex);
+    return st;
+  }
+
+  thrd_t* threads = texec_allocate(ws_ex->base.alloc, cfg->thread_count * sizeof(thrd_t), _Alignof(thrd_t));
+  if (!threads) {
+    ws_destroy_unchecked(ws_ex);
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+  ws_ex->threads = threads;
+  ws_ex->thread_count = cfg->thread_count;
+
+  ws_worker_t* workers = texec_allocate(ws_ex->base.alloc, cfg->thread_count * sizeof(ws_worker_t), _Alignof(ws_worker_t));
+  if (!workers) {
+    ws_destroy_unchecked(ws_ex);
+    return TEXEC_STATUS_OUT_OF_MEMORY;
+  }
+  ws_ex->workers = workers;
+
+  st = ws_init_workers(ws_ex, cfg->queue_capacity);
+  if (st != TEXEC_STATUS_OK) {
+    ws_destroy_unchecked(ws_ex);
+    return st;
+  }
+
+  const texec_queue_create_mode_info_t qmi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_QUEUE_CREATE_MODE_INFO, .next = NULL},
+    .mode = TEXEC_QUEUE_MODE_LOCK_FREE,
+  };
+  const texec_queue_create_info_t qi = {
+    .header = {.type = TEXEC_STRUCT_TYPE_QUEUE_CREATE_INFO, .next = &qmi},
+    .capacity = cfg->queue_capacity,
+  };
+  texec_queue_t* q = NULL;
+  st = texec_queue_create(&qi, ws_ex->base.alloc, &q);
+  if (st != TEXEC_STATUS_OK) {
+    ws_destroy_unchecked(ws_ex);
+    return st;
+  }
+  ws_ex->injector = q;
+
+  st = ws_start_workers(ws_ex);
+  if (st != TEXEC_STATUS_OK) {
+    ws_destroy_unchecked(ws_ex);
+    return st;
+  }
+
+  *out_ex = (texec_executor_t*)ws_ex;
+  return TEXEC_STATUS_OK;
+}
@@ -0,0 +1,84 @@
+#include "internal/ws_deque.h"
+
+#include "internal/allocator.h"
+
+static inline size_t round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+texec_status_t texec_ws_deque_init(texec_ws_deque_t* d, size_t min_capacity, const texec_allocator_t* alloc) {
+  const size_t capacity = round_up_pow2(min_capacity ? min_capacity : 1);
+
+  atomic_uintptr_t* buf = texec_allocate(alloc, capacity * sizeof(atomic_uintptr_t), _Alignof(atomic_uintptr_t));
+  if (!buf) return TEXEC_STATUS_OUT_OF_MEMORY;
+
+  for (size_t i = 0; i < capacity; ++i) {
+    atomic_init(&buf[i], 0);
+  }
+
+  atomic_init(&d->top, 0);
+  atomic_init(&d->bottom, 0);
+  d->buf = buf;
+  d->mask = capacity - 1;
+  d->alloc = alloc;
+  return TEXEC_STATUS_OK;
+}
+
+void texec_ws_deque_destroy(texec_ws_deque_t* d) {
+  if (!d->buf) return;
+  texec_free(d->alloc, d->buf, (d->mask + 1) * sizeof(atomic_uintptr_t), _Alignof(atomic_uintptr_t));
+  d->buf = NULL;
+}
+
+bool texec_ws_deque_push(texec_ws_deque_t* d, uintptr_t item) {
+  const ptrdiff_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+  const ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  if ((size_t)(b - t) > d->mask) return false;
+
+  atomic_store_explicit(&d->buf[(size_t)b & d->mask], item, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+  return true;
+}
+
+bool texec_ws_deque_pop(texec_ws_deque_t* d, uintptr_t* out_item) {
+  const ptrdiff_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+  if (t > b) {
+    // Empty
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return false;
+  }
+
+  const uintptr_t item = atomic_load_explicit(&d->buf[(size_t)b & d->mask], memory_order_relaxed);
+  if (t == b) {
+    // Last item: race against thieves for it.
+    const bool won = atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    if (!won) return false;
+  }
+
+  *out_item = item;
+  return true;
+}
+
+bool texec_ws_deque_steal(texec_ws_deque_t* d, uintptr_t* out_item) {
+  ptrdiff_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  const ptrdiff_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+
+  if (t >= b) return false;
+
+  const uintptr_t item = atomic_load_explicit(&d->buf[(size_t)t & d->mask], memory_order_relaxed);
+  if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+    return false;
+  }
+
+  *out_item = item;
+  return true;
+}
@@ -0,0 +1,216 @@
+#include "internal/mpmc_ring.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <threads.h>
+
+#include "internal/allocator.h"
+
+#include "texec_test.h"
+
+static uint64_t lcg_next(uint64_t* state) {
+  *state = *state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+  return *state >> 17;
+}
+
+// Capacity rounds up to a power of two, and exactly that many items fit.
+static int test_capacity_and_full(void) {
+  const texec_allocator_t* alloc = texec_get_default_allocator();
+  texec_mpmc_ring_t r;
+  TEXEC_CHECK(texec_mpmc_ring_init(&r, 5, alloc) == TEXEC_STATUS_OK);
+  TEXEC_CHECK(texec_mpmc_ring_capacity(&r) == 8);
+
+  for (uintptr_t i = 1; i <= 8; ++i) TEXEC_CHECK(texec_mpmc_ring_try_push(&r, i) == TEXEC_STATUS_OK);
+  TEXEC_CHECK(texec_mpmc_ring_try_push(&r, 9) == TEXEC_STATUS_REJECTED);
+  TEXEC_CHECK(texec_mpmc_ring_size(&r) == 8);
+
+  uintptr_t item = 0;
+  for (uintptr_t i = 1; i <= 8; ++i) {
+    TEXEC_CHECK(texec_mpmc_ring_try_pop(&r, &item) == TEXEC_STATUS_OK);
+    TEXEC_CHECK(item == i);
+  }
+  TEXEC_CHECK(texec_mpmc_ring_try_pop(&r, &item) == TEXEC_STATUS_REJECTED);
+  TEXEC_CHECK(texec_mpmc_ring_size(&r) == 0);
+
+  texec_mpmc_ring_destroy(&r, alloc);
+  return 0;
+}
+
+// Many laps of single and bulk pushes and pops of random sizes, so that bulk claims keep
+// straddling the end of the slot array: every claim takes as much as fits, in FIFO order.
+static int test_wrap_around(void) {
+  const texec_allocator_t* alloc = texec_get_default_allocator();
+  texec_mpmc_ring_t r;
+  TEXEC_CHECK(texec_mpmc_ring_init(&r, 8, alloc) == TEXEC_STATUS_OK);
+
+  uint64_t rng = 7;
+  uintptr_t next_push = 1;
+  uintptr_t next_pop = 1;
+  uintptr_t items[12];
+
+  for (int round = 0; round < 2000; ++round) {
+    const size_t queued = (size_t)(next_push - next_pop);
+    TEXEC_CHECK(texec_mpmc_ring_size(&r) == queued);
+
+    const size_t want = 1 + (size_t)(lcg_next(&rng) % 12);
+    const size_t room = 8 - queued;
+    size_t n = 0;
+    if (want == 1) {
+      TEXEC_CHECK(texec_mpmc_ring_try_push(&r, next_push) == (room ? TEXEC_STATUS_OK : TEXEC_STATUS_REJECTED));
+      n = room ? 1 : 0;
+    } else {
+      for (size_t i = 0; i < want; ++i) items[i] = next_push + i;
+      const texec_status_t st = texec_mpmc_ring_try_push_many(&r, items, want, &n);
+      TEXEC_CHECK(st == (room ? TEXEC_STATUS_OK : TEXEC_STATUS_REJECTED));
+      if (!room) n = 0;
+      TEXEC_CHECK(n == (want < room ? want : room));
+    }
+    next_push += n;
+
+    const size_t available = (size_t)(next_push - next_pop);
+    const size_t take = 1 + (size_t)(lcg_next(&rng) % 12);
+    if (take == 1) {
+      uintptr_t item = 0;
+      TEXEC_CHECK(texec_mpmc_ring_try_pop(&r, &item) == (available ? TEXEC_STATUS_OK : TEXEC_STATUS_REJECTED));
+      if (available) TEXEC_CHECK(item == next_pop++);
+    } else {
+      size_t popped = 0;
+      const texec_status_t st = texec_mpmc_ring_try_pop_many(&r, items, take, &popped);
+      TEXEC_CHECK(st == (available ? TEXEC_STATUS_OK : TEXEC_STATUS_REJECTED));
+      if (!available) continue;
+      TEXEC_CHECK(popped == (take < available ? take : available));
+      for (size_t i = 0; i < popped; ++i) TEXEC_CHECK(items[i] == next_pop++);
+    }
+  }
+
+  // Enough laps that the sequence numbers went round the slot array many times
+  TEXEC_CHECK(next_pop > 100 * 8);
+
+  texec_mpmc_ring_destroy(&r, alloc);
+  return 0;
+}
+
+// Closing refuses new pushes, even into free slots, while pops drain what is left and only then
+// report CLOSED.
+static int test_close(void) {
+  const texec_allocator_t* alloc = texec_get_default_allocator();
+  texec_mpmc_ring_t r;
+  TEXEC_CHECK(texec_mpmc_ring_init(&r, 4, alloc) == TEXEC_STATUS_OK);
+
+  // Start past the end of the slot array so the drained items wrap
+  uintptr_t item = 0;
+  for (uintptr_t i = 0; i < 3; ++i) {
+    TEXEC_CHECK(texec_mpmc_ring_try_push(&r, 100 + i) == TEXEC_STATUS_OK);
+    TEXEC_CHECK(texec_mpmc_ring_try_pop(&r, &item) == TEXEC_STATUS_OK);
+  }
+  const uintptr_t items[3] = {1, 2, 3};
+  size_t n = 0;
+  TEXEC_CHECK(texec_mpmc_ring_try_push_many(&r, items, 3, &n) == TEXEC_STATUS_OK && n == 3);
+
+  TEXEC_CHECK(!texec_mpmc_ring_is_closed(&r));
+  texec_mpmc_ring_close(&r);
+  texec_mpmc_ring_close(&r); // idempotent
+  TEXEC_CHECK(texec_mpmc_ring_is_closed(&r));
+
+  TEXEC_CHECK(texec_mpmc_ring_try_push(&r, 4) == TEXEC_STATUS_CLOSED);
+  TEXEC_CHECK(texec_mpmc_ring_try_push_many(&r, items, 3, &n) == TEXEC_STATUS_CLOSED);
+
+  TEXEC_CHECK(texec_mpmc_ring_try_pop(&r, &item) == TEXEC_STATUS_OK && item == 1);
+  uintptr_t out[4];
+  size_t popped = 0;
+  TEXEC_CHECK(texec_mpmc_ring_try_pop_many(&r, out, 4, &popped) == TEXEC_STATUS_OK);
+  TEXEC_CHECK(popped == 2 && out[0] == 2 && out[1] == 3);
+
+  TEXEC_CHECK(texec_mpmc_ring_try_pop(&r, &item) == TEXEC_STATUS_CLOSED);
+  TEXEC_CHECK(texec_mpmc_ring_try_pop_many(&r, out, 4, &popped) == TEXEC_STATUS_CLOSED);
+  TEXEC_CHECK(texec_mpmc_ring_try_push(&r, 4) == TEXEC_STATUS_CLOSED);
+
+  texec_mpmc_ring_destroy(&r, alloc);
+  return 0;
+}
+
+enum { THREAD_COUNT = 4, ITEMS_PER_PRODUCER = 50000 };
+
+typedef struct concurrent_state {
+  texec_mpmc_ring_t ring;
+  atomic_uchar seen[THREAD_COUNT * ITEMS_PER_PRODUCER];
+  atomic_size_t popped;
+  atomic_int errors;
+} concurrent_state_t;
+
+typedef struct producer_arg {
+  concurrent_state_t* state;
+  uintptr_t first;
+} producer_arg_t;
+
+static int producer_main(void* arg) {
+  const producer_arg_t* p = arg;
+  for (uintptr_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+    texec_status_t st;
+    while ((st = texec_mpmc_ring_try_push(&p->state->ring, p->first + i)) == TEXEC_STATUS_REJECTED) thrd_yield();
+    if (st != TEXEC_STATUS_OK) atomic_fetch_add(&p->state->errors, 1);
+  }
+  return 0;
+}
+
+static int consumer_main(void* arg) {
+  concurrent_state_t* state = arg;
+  uintptr_t items[16];
+  for (;;) {
+    size_t n = 0;
+    const texec_status_t st = texec_mpmc_ring_try_pop_many(&state->ring, items, 16, &n);
+    if (st == TEXEC_STATUS_CLOSED) return 0;
+    if (st == TEXEC_STATUS_REJECTED) {
+      thrd_yield();
+      continue;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      if (items[i] >= THREAD_COUNT * ITEMS_PER_PRODUCER || atomic_fetch_add(&state->seen[items[i]], 1) != 0) {
+        atomic_fetch_add(&state->errors, 1);
+      }
+    }
+    atomic_fetch_add(&state->popped, n);
+  }
+}
+
+// Producers and consumers racing through a small ring: every item is popped exactly once, and
+// consumers see CLOSED only after the ring is closed and drained.
+static int test_concurrent_close(void) {
+  static concurrent_state_t state;
+  const texec_allocator_t* alloc = texec_get_default_allocator();
+  TEXEC_CHECK(texec_mpmc_ring_init(&state.ring, 64, alloc) == TEXEC_STATUS_OK);
+  for (size_t i = 0; i < THREAD_COUNT * ITEMS_PER_PRODUCER; ++i) atomic_init(&state.seen[i], 0);
+  atomic_init(&state.popped, 0);
+  atomic_init(&state.errors, 0);
+
+  thrd_t producers[THREAD_COUNT];
+  thrd_t consumers[THREAD_COUNT];
+  producer_arg_t args[THREAD_COUNT];
+  for (size_t i = 0; i < THREAD_COUNT; ++i) {
+    args[i] = (producer_arg_t){.state = &state, .first = i * ITEMS_PER_PRODUCER};
+    TEXEC_CHECK(thrd_create(&consumers[i], consumer_main, &state) == thrd_success);
+    TEXEC_CHECK(thrd_create(&producers[i], producer_main, &args[i]) == thrd_success);
+  }
+
+  for (size_t i = 0; i < THREAD_COUNT; ++i) thrd_join(producers[i], NULL);
+  texec_mpmc_ring_close(&state.ring);
+  for (size_t i = 0; i < THREAD_COUNT; ++i) thrd_join(consumers[i], NULL);
+
+  TEXEC_CHECK(atomic_load(&state.errors) == 0);
+  TEXEC_CHECK(atomic_load(&state.popped) == THREAD_COUNT * ITEMS_PER_PRODUCER);
+
+  texec_mpmc_ring_destroy(&state.ring, alloc);
+  return 0;
+}
+
+int main(void) {
+  int failures = 0;
+  TEXEC_RUN_TEST(failures, test_capacity_and_full);
+  TEXEC_RUN_TEST(failures, test_wrap_around);
+  TEXEC_RUN_TEST(failures, test_close);
+  TEXEC_RUN_TEST(failures, test_concurrent_close);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdio.h>
+
+// Minimal checks for the unit tests: a failed check reports where and makes the test function
+// it appears in return 1, which the test's main turns into its exit code for ctest.
+#define TEXEC_CHECK(cond)                                                              \
+  do {                                                                                 \
+    if (!(cond)) {                                                                     \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);        \
+      return 1;                                                                        \
+    }                                                                                  \
+  } while (0)
+
+#define TEXEC_RUN_TEST(failures, test)                                                 \
+  do {                                                                                 \
+    if ((test)() != 0) {                                                               \
+      fprintf(stderr, "%s failed\n", #test);                                           \
+      ++(failures);                                                                    \
+    }                                                                                  \
+  } while (0)
@@ -0,0 +1,172 @@
+#include "internal/timer_wheel.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "texec_test.h"
+
+// Ticks the whole wheel spans, as in timer_wheel.c
+#define WHEEL_SPAN (UINT64_C(1) << (6 * TEXEC_TIMER_WHEEL_LEVELS))
+
+#define COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint64_t lcg_next(uint64_t* state) {
+  *state = *state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+  return *state >> 17;
+}
+
+// Inserts one entry per `when`, in reverse order so that insertion order does not match due order.
+static void insert_all(texec_timer_wheel_t* w, texec_timer_wheel_entry_t* entries, const uint64_t* whens, size_t count) {
+  for (size_t i = count; i-- > 0;) {
+    entries[i].when = whens[i];
+    texec_timer_wheel_insert(w, &entries[i]);
+  }
+}
+
+// Advances to each expiration the wheel reports in turn and checks that every entry comes out at
+// exactly its tick, which also means in tick order, and that `count` entries come out in all.
+static int drain_in_order(texec_timer_wheel_t* w, size_t count) {
+  size_t seen = 0;
+  while (w->count != 0) {
+    const uint64_t next = texec_timer_wheel_next_expiration(w);
+    TEXEC_CHECK(next > w->elapsed);
+
+    for (texec_timer_wheel_entry_t* e = texec_timer_wheel_advance(w, next); e; e = e->next) {
+      TEXEC_CHECK(e->when == next);
+      ++seen;
+    }
+    TEXEC_CHECK(w->elapsed == next);
+  }
+
+  TEXEC_CHECK(seen == count);
+  TEXEC_CHECK(texec_timer_wheel_next_expiration(w) == UINT64_MAX);
+  return 0;
+}
+
+// Entries on either side of each level boundary cascade down and come out in order.
+static int test_cascade_across_levels(void) {
+  static const uint64_t whens[] = {
+    1,
+    63, 64, 65,
+    4095, 4096, 4097,
+    262143, 262144, 262145,
+    (UINT64_C(1) << 24) - 1, UINT64_C(1) << 24, (UINT64_C(1) << 24) + 1,
+    (UINT64_C(1) << 30) + 3,
+    WHEEL_SPAN - 1,
+  };
+
+  texec_timer_wheel_t w;
+  texec_timer_wheel_entry_t entries[COUNT_OF(whens)];
+  texec_timer_wheel_init(&w);
+  insert_all(&w, entries, whens, COUNT_OF(whens));
+  TEXEC_CHECK(w.count == COUNT_OF(whens));
+  if (drain_in_order(&w, COUNT_OF(whens)) != 0) return 1;
+
+  // The same from a position that is not aligned to any level
+  const uint64_t base = 3 * UINT64_C(4096) - 7;
+  texec_timer_wheel_init(&w);
+  TEXEC_CHECK(texec_timer_wheel_advance(&w, base) == NULL);
+  uint64_t shifted[COUNT_OF(whens)];
+  for (size_t i = 0; i < COUNT_OF(whens); ++i) shifted[i] = base + whens[i];
+  insert_all(&w, entries, shifted, COUNT_OF(shifted));
+  return drain_in_order(&w, COUNT_OF(shifted));
+}
+
+// Entries farther out than the wheel spans wait in the top level for as many turns as they need,
+// without holding back nearer entries or coming out early.
+static int test_beyond_max_span(void) {
+  texec_timer_wheel_t w;
+  texec_timer_wheel_init(&w);
+
+  const uint64_t base = 12345;
+  TEXEC_CHECK(texec_timer_wheel_advance(&w, base) == NULL);
+
+  const uint64_t whens[] = {
+    base + 10,
+    base + (UINT64_C(1) << 30) + 3, // top level, due before the far entries sharing the current slot
+    base + WHEEL_SPAN - 1,
+    base + WHEEL_SPAN,
+    base + WHEEL_SPAN + 1,
+    base + 3 * WHEEL_SPAN + 64,
+    base + 5 * WHEEL_SPAN + 4097,
+  };
+  texec_timer_wheel_entry_t entries[COUNT_OF(whens)];
+  insert_all(&w, entries, whens, COUNT_OF(whens));
+  TEXEC_CHECK(texec_timer_wheel_next_expiration(&w) <= base + 10); // may be a cascade first
+  if (drain_in_order(&w, COUNT_OF(whens)) != 0) return 1;
+
+  // A single jump that stops one tick short leaves the entry in place
+  texec_timer_wheel_entry_t far = {.when = w.elapsed + 2 * WHEEL_SPAN + 5};
+  texec_timer_wheel_insert(&w, &far);
+  TEXEC_CHECK(texec_timer_wheel_advance(&w, far.when - 1) == NULL);
+  TEXEC_CHECK(w.count == 1);
+  TEXEC_CHECK(texec_timer_wheel_advance(&w, far.when) == &far);
+  TEXEC_CHECK(far.next == NULL && w.count == 0);
+  return 0;
+}
+
+// Random entries and random advance steps: every entry comes out in the first advance that
+// reaches its tick, removed entries never do, and take_all returns whatever is left.
+static int test_random_against_reference(void) {
+  enum { ENTRY_COUNT = 2000 };
+  static texec_timer_wheel_entry_t entries[ENTRY_COUNT];
+  static bool pending[ENTRY_COUNT];
+  static const uint64_t ranges[] = {64, 4096, UINT64_C(1) << 20, UINT64_C(1) << 30, 4 * WHEEL_SPAN};
+
+  uint64_t rng = 42;
+  texec_timer_wheel_t w;
+  texec_timer_wheel_init(&w);
+  TEXEC_CHECK(texec_timer_wheel_advance(&w, 1000) == NULL);
+
+  size_t linked = 0;
+  for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+    entries[i].when = w.elapsed + 1 + lcg_next(&rng) % ranges[lcg_next(&rng) % COUNT_OF(ranges)];
+    texec_timer_wheel_insert(&w, &entries[i]);
+    pending[i] = true;
+    ++linked;
+  }
+
+  for (size_t i = 0; i < ENTRY_COUNT; i += 7) {
+    texec_timer_wheel_remove(&w, &entries[i]);
+    pending[i] = false;
+    --linked;
+  }
+  TEXEC_CHECK(w.count == linked);
+
+  for (int step = 0; step < 200 && w.count != 0; ++step) {
+    const uint64_t before = w.elapsed;
+    const uint64_t now = before + 1 + lcg_next(&rng) % ranges[lcg_next(&rng) % (COUNT_OF(ranges) - 1)];
+
+    for (texec_timer_wheel_entry_t* e = texec_timer_wheel_advance(&w, now); e; e = e->next) {
+      const size_t i = (size_t)(e - entries);
+      TEXEC_CHECK(i < ENTRY_COUNT && pending[i]);
+      TEXEC_CHECK(e->when > before && e->when <= now);
+      pending[i] = false;
+      --linked;
+    }
+    TEXEC_CHECK(w.elapsed == now && w.count == linked);
+
+    for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+      TEXEC_CHECK(!pending[i] || entries[i].when > now);
+    }
+  }
+
+  for (texec_timer_wheel_entry_t* e = texec_timer_wheel_take_all(&w); e; e = e->next) {
+    const size_t i = (size_t)(e - entries);
+    TEXEC_CHECK(i < ENTRY_COUNT && pending[i]);
+    pending[i] = false;
+    --linked;
+  }
+  TEXEC_CHECK(linked == 0 && w.count == 0);
+  TEXEC_CHECK(texec_timer_wheel_next_expiration(&w) == UINT64_MAX);
+  return 0;
+}
+
+int main(void) {
+  int failures = 0;
+  TEXEC_RUN_TEST(failures, test_cascade_across_levels);
+  TEXEC_RUN_TEST(failures, test_beyond_max_span);
+  TEXEC_RUN_TEST(failures, test_random_against_reference);
+  return failures == 0 ? 0 : 1;
+}